@@ -0,0 +1,86 @@
+#! /bin/sh
+
+# Time the canonical heavy computations over a fixed ladder of groups.
+#
+#   sh bench.sh [quick|full] [output file]
+#
+# Each case runs the atlas program on a fixed block, and writes the figures
+# recorded by the library (time, largest resident size and counters for each
+# phase, see "profile_json") as one member of a JSON array, by default to the
+# file bench-results.json. The ladder "quick" (the default) takes seconds; the
+# ladder "full" adds E6, E7 and selected E8 blocks, and takes far longer. Set
+# THREADS to have the library use more threads.
+
+ladder=${1:-quick}
+out=${2:-bench-results.json}
+threads=${THREADS:-1}
+
+case $ladder in quick|full) ;; *) echo "Unknown ladder $ladder"; exit 1;; esac
+if ! test -x ./atlas; then echo "First build atlas"; exit 1; fi
+
+# bench_case name real_form dual_real_form steps
+# where steps is a subset of "kl cells ext deform full_deform"; the KGB sets
+# and the block are always generated, the other steps are done for the block,
+# or for the block of the trivial representation (ext, deform, full_deform)
+bench_case ()
+{
+  echo "$1: block $4" >&2
+  {
+    echo "set G = $2"
+    echo "set b = block(G,$3)"
+    for s in $4
+    do case $s in
+	kl) echo "set kl = raw_KL(b)";;
+	cells) echo "set cells = W_cells(b)";;
+	ext) echo "set ext = extended_KL_block" \
+		  "(trivial(G),distinguished_involution(inner_class(G)))";;
+	deform) echo "set d = deform(trivial(G))";;
+	full_deform) echo "set f = full_deform(trivial(G))";;
+       esac
+    done
+    echo 'prints("size ",#b)'
+    echo 'prints(profile_json())'
+  } >bench-case.at
+  result=$(./atlas --threads=$threads --path=atlas-scripts basic.at groups.at \
+		 <bench-case.at 2>&1)
+  size=$(echo "$result" | sed -n -e 's/^size //p')
+  if test $count -gt 0; then echo ","; fi
+  printf '{ "case": "%s", "threads": %s, "block size": %s,\n  "profile": ' \
+	 "$1" "$threads" "${size:-null}"
+  if test -n "$size"
+  then echo "$result" | sed -n -e '/^{$/,/^}$/p' | sed -e '2,$s/^/  /'
+  else echo "null"; echo "$result" >&2 # atlas failed, show why
+  fi
+  echo "}"
+  count=$((count+1))
+}
+
+count=0
+{
+  echo "["
+  bench_case "Sp(8,R)" "Sp_R(8)" "dual_quasisplit_form(inner_class(G))" \
+	     "kl cells ext deform full_deform"
+  bench_case "SO(5,4)" "SO(5,4)" "dual_quasisplit_form(inner_class(G))" \
+	     "kl cells ext deform full_deform"
+  bench_case "SO(4,4)" "SO(4,4)" "dual_quasisplit_form(inner_class(G))" \
+	     "kl cells ext deform full_deform"
+  bench_case "F4 split" 'split_form(Lie_type("F4"))' \
+	     "dual_quasisplit_form(inner_class(G))" \
+	     "kl cells ext deform full_deform"
+  if test $ladder = full
+  then
+    bench_case "E6 split" 'split_form(Lie_type("E6"))' \
+	       "dual_quasisplit_form(inner_class(G))" \
+	       "kl cells ext deform"
+    bench_case "E7 split" 'split_form(Lie_type("E7"))' \
+	       "dual_quasisplit_form(inner_class(G))" "kl cells"
+    E8_ic='inner_class(simply_connected(Lie_type("E8")),"s")'
+    bench_case "E8 (1,1)" "real_form($E8_ic,1)" \
+	       "dual_real_form(inner_class(G),1)" "kl cells"
+    bench_case "E8 (1,2)" "real_form($E8_ic,1)" \
+	       "dual_real_form(inner_class(G),2)" "kl"
+  fi
+  echo "]"
+} >$out
+rm -f bench-case.at
+echo "Results written to $out" >&2
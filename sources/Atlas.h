@@ -119,10 +119,14 @@ namespace atlas {
     typedef unsigned long long int Denom_t;
     class Rational;
     class Split_integer;
+    class big_int;
+    class big_rat;
   }
   using arithmetic::Rational;
   typedef std::vector<Rational> RationalList;
   using arithmetic::Split_integer;
+  using arithmetic::big_int;
+  using arithmetic::big_rat;
 
   namespace matrix {
     template<typename C> class Vector;
@@ -158,8 +162,10 @@ namespace atlas {
 
   namespace hashtable{
     template <class Entry, typename Number> class HashTable;
+    template <class Entry, typename Number> class ConcurrentHashTable;
   }
   using hashtable::HashTable;
+  using hashtable::ConcurrentHashTable;
 
   namespace free_abelian {
     template<typename T, typename C=long int, typename Compare=std::less<T> >
@@ -170,6 +176,8 @@ namespace atlas {
   namespace polynomials {
     template<typename C> class Polynomial;
     template<typename C> class Safe_Poly;
+    template<typename C> class Poly_ref;
+    template<typename C> class Poly_store;
     typedef size_t Degree; // exponent range; not stored.
   }
   using polynomials::Polynomial;
@@ -432,8 +440,8 @@ namespace atlas {
     typedef polynomials::Safe_Poly<KLCoeff> KLPol;
     typedef unsigned int KLIndex; // $<2^{32}$ distinct polynomials for $E_8$!
     typedef KLCoeff MuCoeff;
-    typedef std::vector<KLPol> KLStore;
-    typedef KLStore::const_reference KLPolRef;
+    typedef polynomials::Poly_store<KLCoeff> KLStore;
+    typedef polynomials::Poly_ref<KLCoeff> KLPolRef;
     typedef std::vector<KLIndex> KLRow;
     typedef std::vector<BlockElt> PrimitiveRow;
   }
@@ -11,15 +11,18 @@
 #include "blocks.h"
 
 #include <cassert>
+#include <fstream>
 #include <vector>
-#include <set> // for |insertAscents|
 #include <algorithm>
 #include <iterator>
 
 #include "arithmetic.h"
+#include "basic_io.h"	// for binary cache files
 
 #include "tags.h"
 #include "hashtable.h"
+#include "parallel.h" // for |makeHasse|
+#include "profile.h"
 
 #include "bruhat.h"	// construction
 #include "innerclass.h"
@@ -164,7 +167,7 @@ inline BlockElt& first_free_slot(BlockEltPair& p)
 }
 
 Block_base::Block_base(const KGB& kgb,const KGB& dual_kgb)
-  : info(), data(kgb.rank()), orbits()
+  : d_rank(kgb.rank()), info(), data(), orbits()
   , dd(kgb.innerClass().rootDatum().cartanMatrix())
   , d_bruhat(NULL)
   , klc_ptr(NULL)
@@ -173,14 +176,14 @@ Block_base::Block_base(const KGB& kgb,const KGB& dual_kgb)
 
 // an almost trivial constructor used for derived non-integral block types
 Block_base::Block_base(unsigned int rank)
-  : info(), data(rank), orbits()
+  : d_rank(rank), info(), data(), orbits()
   , dd()
   , d_bruhat(NULL)
   , klc_ptr(NULL)
 {}
 
 Block_base::Block_base(const Block_base& b) // copy constructor, unused
-  : info(b.info), data(b.data), orbits(b.orbits)
+  : d_rank(b.d_rank), info(b.info), data(b.data), orbits(b.orbits)
   , dd(b.dd)
   , d_bruhat(NULL) // don't care to copy; is empty in |Block::build| anyway
   , klc_ptr(NULL)  // likewise
@@ -304,23 +307,24 @@ void param_block::reverse_length_and_sort(bool full_block)
   if (not full_block) // data fields are inserted only later for partial block
     return; // so in that case we are done
 
-  // now adapt |data| tables, assumed to be already computed
-  for (weyl::Generator s=0; s<rank(); ++s)
-  {
-    std::vector<block_fields>& tab_s = data[s];
-    ranks.permute(tab_s); // permute fields of |data[s]|
-    for (BlockElt z=0; z<size(); ++z) // and update cross and Cayley links
-    {
-      tab_s[z].cross_image = ranks[tab_s[z].cross_image];
-      BlockEltPair& p=tab_s[z].Cayley_image;
+  // now adapt |data| table, assumed to be already computed
+  assert(data.size()==size()*rank());
+  std::vector<block_fields> new_data(data.size());
+  for (BlockElt z=0; z<size(); ++z) // move fields of |z| to its new place
+    for (weyl::Generator s=0; s<rank(); ++s)
+    { // and update cross and Cayley links
+      block_fields& f = new_data[ranks[z]*d_rank+s];
+      f = fields(s,z);
+      f.cross_image = ranks[f.cross_image];
+      BlockEltPair& p=f.Cayley_image;
       if (p.first!=UndefBlock)
       {
 	p.first=ranks[p.first];
 	if (p.second!=UndefBlock)
 	  p.second=ranks[p.second];
       }
-    } // |for z|
-  } // |for s|
+    } // |for s|
+  data.swap(new_data);
 
 } // |param_block::reverse_length_and_sort|
 
@@ -415,18 +419,32 @@ void Block_base::fillBruhat()
 {
   if (d_bruhat==NULL) // do this only the first time
   {
+    profile::phase timer("Bruhat order");
     std::vector<set::EltList> hd = makeHasse(*this);
-    d_bruhat = new BruhatOrder(hd); // commit iff new completed without throwing
+    timer.count("elements",hd.size());
+    for (BlockElt z=0; z<hd.size(); ++z)
+      timer.count("covering relations",hd[z].size());
+    d_bruhat = new BruhatOrder(std::move(hd)); // commit iff new completed without throwing
   }
 }
 
-// computes and stores the KL polynomials
-void Block_base::fill_klc(BlockElt last_y,bool verbose)
+kl::KLContext& Block_base::KL_context()
 {
   if (klc_ptr==NULL) // do this only the first time
     klc_ptr=new kl::KLContext(*this);
+  return *klc_ptr;
+}
 
-  klc_ptr->fill(last_y,verbose); // extend tables to contain |last_y|
+size_t Block_base::memory_use() const
+{
+  return info.capacity()*sizeof(EltInfo) + data.capacity()*sizeof(block_fields)
+    + (klc_ptr==NULL ? 0 : klc_ptr->memory_use());
+}
+
+// computes and stores the KL polynomials
+void Block_base::fill_klc(BlockElt last_y,bool verbose)
+{
+  KL_context().fill(last_y,verbose); // extend tables to contain |last_y|
 }
 
 
@@ -459,6 +477,7 @@ Block::Block(const KGB& kgb,const KGB& dual_kgb)
   , d_Cartan(), d_involution(), d_first_z_of_x(), d_involutionSupport()
     // these fields are filled below
 {
+  profile::phase timer("block");
   const TwistedWeylGroup& dual_tW =dual_kgb.twistedWeylGroup();
 
   std::vector<TwistedInvolution> dual_w; // tabulate bijection |tW->dual_tW|
@@ -491,45 +510,54 @@ Block::Block(const KGB& kgb,const KGB& dual_kgb)
 
   // Now |element| can be safely called; install cross and Cayley tables
 
-  for (weyl::Generator s = 0; s<rank(); ++s)
-  { // the generation below is completely independent for each |s|
-    data[s].resize(size);
-    for (BlockElt z=0; z<size; ++z)
-    {
-      data[s][z].cross_image
-	= element(kgb.cross(s,x(z)),dual_kgb.cross(s,y(z)));
-      switch (descentValue(s,z))
+  const std::vector<int> key = cache_key(kgb,dual_kgb);
+  if (not read_cache(key)) // then compute links and duals, and save them
+  {
+    data.resize(size*rank());
+    for (weyl::Generator s = 0; s<rank(); ++s)
+    { // the generation below is completely independent for each |s|
+      for (BlockElt z=0; z<size; ++z)
       {
-      default: break; // most cases leave |data[s][z].Cayley_image| undefined
-      case DescentStatus::ImaginaryTypeII:
-	{
-	  BlockElt z1=element(kgb.cayley(s,x(z)),
-			      dual_kgb.inverseCayley(s,y(z)).second);
-	  data[s][z].Cayley_image.second = z1; // double-valued direct Cayley
-	  data[s][z1].Cayley_image.first = z; // single-valued inverse Cayley
-	}
-	// FALL THROUGH
-      case DescentStatus::ImaginaryTypeI:
+	fields(s,z).cross_image
+	  = element(kgb.cross(s,x(z)),dual_kgb.cross(s,y(z)));
+	switch (descentValue(s,z))
 	{
-	  BlockElt z0=element(kgb.cayley(s,x(z)),
-			      dual_kgb.inverseCayley(s,y(z)).first);
-	  data[s][z].Cayley_image.first = z0;
-	  // in TypeI, |data[s][z].Cayley_image.second| remains |UndefBlock|
-	  first_free_slot(data[s][z0].Cayley_image) = z;
-	}
-      } // switch
-    } // |for (z)|
-  } // |for(s)|
+	default: break; // most cases leave |fields(s,z).Cayley_image| undefined
+	case DescentStatus::ImaginaryTypeII:
+	  {
+	    BlockElt z1=element(kgb.cayley(s,x(z)),
+				dual_kgb.inverseCayley(s,y(z)).second);
+	    fields(s,z).Cayley_image.second = z1; // double-valued direct Cayley
+	    fields(s,z1).Cayley_image.first = z; // single-valued inverse Cayley
+	  }
+	  // FALL THROUGH
+	case DescentStatus::ImaginaryTypeI:
+	  {
+	    BlockElt z0=element(kgb.cayley(s,x(z)),
+				dual_kgb.inverseCayley(s,y(z)).first);
+	    fields(s,z).Cayley_image.first = z0;
+	    // in TypeI, |fields(s,z).Cayley_image.second| remains |UndefBlock|
+	    first_free_slot(fields(s,z0).Cayley_image) = z;
+	  }
+	} // switch
+      } // |for (z)|
+    } // |for(s)|
+
+    // Complete |Block_base| initialisation by installing the dual links.
+    if (dual_kgb.Hermitian_dual(0)!=UndefKGB) // then whole block stable
+    {
+      // the following is correct since |dual_kgb| was built with dual twist
+      for (BlockElt z=0; z<size; ++z)
+	info[z].dual =
+	  element(kgb.Hermitian_dual(x(z)),dual_kgb.Hermitian_dual(y(z)));
+    }
+    write_cache(key); // does nothing unless caching is enabled
+  } // |if (not read_cache(key))|
+  else
+    timer.count("read from cache");
 
-  // Complete |Block_base| initialisation by installing the dual links.
   if (dual_kgb.Hermitian_dual(0)!=UndefKGB) // then whole block stable
-  {
     orbits = tW.twist_orbits(); // orbits on full Dynkin diagram
-    // the following is correct since |dual_kgb| was built with dual twist
-    for (BlockElt z=0; z<size; ++z)
-      info[z].dual =
-	element(kgb.Hermitian_dual(x(z)),dual_kgb.Hermitian_dual(y(z)));
-  }
 
   // Continue filling the fields of the |Block| derived class proper
   d_Cartan.reserve(size);
@@ -542,8 +570,77 @@ Block::Block(const KGB& kgb,const KGB& dual_kgb)
   }
 
   compute_supports();
+  timer.count("elements",size);
 } // |Block::Block(kgb,dual_kgb)|
 
+/*
+  A block is determined by its two KGB sets, which are identified in cache
+  files by their |KGB_base::signature|. The cached tables are those computed
+  from the KGB sets in the constructor: for each element and generator the
+  cross image and the two Cayley images, and then for each element the
+  Hermitian dual (4 bytes each). The file header is as for KGB cache files.
+*/
+std::vector<int> Block::cache_key(const KGB& kgb,const KGB& dual_kgb) const
+{
+  const int block_cache_format=1; // increase when the file format changes
+  const unsigned long long sig[2] = { kgb.signature(), dual_kgb.signature() };
+  std::vector<int> key;
+  key.push_back(block_cache_format);
+  key.push_back(rank());
+  key.push_back(size());
+  for (unsigned int i=0; i<2; ++i)
+  {
+    key.push_back(static_cast<int>(sig[i]&0xFFFFFFFF));
+    key.push_back(static_cast<int>(sig[i]>>32));
+  }
+  return key;
+}
+
+bool Block::read_cache(const std::vector<int>& key)
+{
+  if (kgb::cache_directory().empty())
+    return false;
+  std::ifstream in
+    (kgb::cache_file_name("block",key).c_str(),std::ios_base::binary);
+  if (not in.is_open() or not kgb::cache_header_matches(in,key))
+    return false;
+
+  using basic_io::read_bytes;
+  std::vector<block_fields> new_data(size()*rank());
+  for (auto it=new_data.begin(); it!=new_data.end(); ++it)
+  {
+    it->cross_image = read_bytes<4>(in);
+    it->Cayley_image.first = read_bytes<4>(in);
+    it->Cayley_image.second = read_bytes<4>(in);
+  }
+  std::vector<BlockElt> duals(size());
+  for (BlockElt z=0; z<size(); ++z)
+    duals[z] = read_bytes<4>(in);
+  if (not in.good()) // file was truncated; ignore it
+    return false;
+
+  data.swap(new_data);
+  for (BlockElt z=0; z<size(); ++z)
+    info[z].dual = duals[z];
+  return true;
+} // |Block::read_cache|
+
+void Block::write_cache(const std::vector<int>& key) const
+{
+  kgb::write_cache_file("block",key,[this](std::ostream& out)
+  {
+    using basic_io::write_bytes;
+    for (auto it=data.begin(); it!=data.end(); ++it)
+    {
+      write_bytes<4>(it->cross_image,out);
+      write_bytes<4>(it->Cayley_image.first,out);
+      write_bytes<4>(it->Cayley_image.second,out);
+    }
+    for (BlockElt z=0; z<size(); ++z)
+      write_bytes<4>(info[z].dual,out);
+  });
+} // |Block::write_cache|
+
 // Construction function for the |Block| class.
 // It is a pseudo constructor method that ends calling main contructor
 Block Block::build(InnerClass& G, RealFormNbr rf, RealFormNbr drf)
@@ -953,6 +1050,7 @@ param_block::param_block // full block constructor
   , y_bits()
   , z_hash(info)
 {
+  profile::phase timer("param block");
   const InnerClass& G = innerClass();
   const RootDatum& rd = G.rootDatum();
 
@@ -1027,8 +1125,7 @@ param_block::param_block // full block constructor
 
     // now insert elements from |yy_hash| as first R-packet of block
     info.reserve(y_hash.size()); // this is lower bound for final size; reserve
-    for (weyl::Generator s=0; s<our_rank; ++s)
-      data[s].reserve(y_hash.size());
+    data.reserve(y_hash.size()*our_rank);
 
     for (size_t i=0; i<y_hash.size(); ++i)
       add_z(x0,i); // this adds information to |info|; we leave |length==0|
@@ -1072,8 +1169,7 @@ param_block::param_block // full block constructor
 
     for (weyl::Generator s=0; s<our_rank; ++s)
     {
-      std::vector<block_fields>& tab_s = data[s];
-      tab_s.resize(info.size()); // ensure enough slots for now
+      data.resize(info.size()*our_rank); // ensure enough slots for now
 
       unsigned int y_start=y_hash.size(); // new |y|s numbered from here up
 
@@ -1111,7 +1207,7 @@ param_block::param_block // full block constructor
 	  x_seen.insert(s_x_n); // record the new |x| value
 	  for (unsigned int j=0; j<nr_y; ++j)
 	  {
-	    tab_s[base_z+j].cross_image = info.size(); // link to new element
+	    fields(s,base_z+j).cross_image = info.size(); // link to new element
 
 	    add_z(s_x_n,cross_ys[j]);
 	    // same |x| neighbour throughout loop, but |y| neighbour varies
@@ -1122,7 +1218,7 @@ param_block::param_block // full block constructor
 	} // |if(new_cross)|
 	else // install cross links to previously existing elements
 	  for (unsigned int j=0; j<nr_y; ++j)
-	    tab_s[base_z+j].cross_image = earlier(s_x_n,cross_ys[j]);
+	    fields(s,base_z+j).cross_image = earlier(s_x_n,cross_ys[j]);
 
 	// compute component |s| of |info[z].descent|, this |n|, all |y|s
 	KGBElt conj_n = kgb.cross(sub.to_simple(s),n); // conjugate
@@ -1222,7 +1318,7 @@ param_block::param_block // full block constructor
 	      }
 
 	    // finallly make sure that Cayley links slots exist for code below
-	    tab_s.resize(info.size());
+	    data.resize(info.size()*our_rank);
 	  } // |if (new_Cayley)|: finished creating new R-packets
 	} // |if (i==0)|: finished work for first |x| when some |y| is parity
 
@@ -1232,15 +1328,15 @@ param_block::param_block // full block constructor
 	  {
 	    KGBElt cty=Cayley_ys[p++]; // unique Cayley transform of |y|
 	    BlockElt target = earlier(ctx1,cty);
-	    tab_s[base_z+j].Cayley_image.first = target;
-	    first_free_slot(tab_s[target].Cayley_image) = base_z+j;
+	    fields(s,base_z+j).Cayley_image.first = target;
+	    first_free_slot(fields(s,target).Cayley_image) = base_z+j;
 	    if (Cayleys.second!=UndefKGB) // then double valued (type1)
 	    {
 	      KGBElt ctx2 = kgb.cross(Cayleys.second,sub.to_simple(s));
 	      assert (x_seen.isMember(ctx2));
 	      target = earlier(ctx2,cty);
-	      tab_s[base_z+j].Cayley_image.second = target;
-	      first_free_slot(tab_s[target].Cayley_image) = base_z+j;
+	      fields(s,base_z+j).Cayley_image.second = target;
+	      first_free_slot(fields(s,target).Cayley_image) = base_z+j;
 	    }
 	  } // |for(j)|
 
@@ -1261,6 +1357,9 @@ param_block::param_block // full block constructor
   // and look up which element matches the original input
   entry_element = lookup(x_org,y_org);
 
+  timer.count("elements",size());
+  timer.count("y values",ysize());
+
 } // |param_block::param_block|, full block version
 
 // a derived class whose main additional method computes a Bruhat order ideal
@@ -1416,7 +1515,7 @@ BlockElt
   block_elt_entry e(z.x(),y_hash.match(pack_y(z)),DescentStatus(),level);
   BlockElt res = z_hash.match(e);
   assert(res==predecessors.size()); // |z| must have been added just now
-  predecessors.push_back(pred); // store list of elements covered by |z|
+  predecessors.push_back(std::move(pred)); // store elements covered by |z|
   return res;
 } // |partial_nblock_help::nblock_below|
 
@@ -1432,6 +1531,7 @@ param_block::param_block // partial block constructor, for interval below |sr|
   , y_bits()
   , z_hash(info)
 {
+  profile::phase timer("partial param block");
   const RootDatum& rd = innerClass().rootDatum();
 
   const KGB& kgb = rc.kgb();
@@ -1460,11 +1560,15 @@ param_block::param_block // partial block constructor, for interval below |sr|
   size_t size= last+1;
   assert(info.size()==size); // |info| should have obtained precisely this size
 
+  // the covering lists served only to generate the Bruhat interval; free them
+  // before link tables are allocated, to reduce the peak memory use
+  std::vector<BlockEltList>().swap(aux.predecessors);
+
 
   reverse_length_and_sort(false); // do reversal operation for partial block
 
   // allocate link fields with |UndefBlock| entries
-  data.assign(our_rank,std::vector<block_fields>(size));
+  data.assign(size*our_rank,block_fields());
 
   // compute all links for all elements in partial block, by increasing length
   for (BlockElt i=0; i<size; ++i)
@@ -1474,7 +1578,6 @@ param_block::param_block // partial block constructor, for interval below |sr|
     DescentStatus& desc_z = info[i].descent;
     for (weyl::Generator s=0; s<our_rank; ++s)
     {
-      auto& tab_s = data[s];
       nblock_elt cur = aux.get(i); // element |z| as |nblock_elt|
 
       KGBElt conj_x = aux.conj_in_x(s,z.x);
@@ -1485,7 +1588,7 @@ param_block::param_block // partial block constructor, for interval below |sr|
 	  aux.cross_act(cur,s);
 	  BlockElt sz = aux.lookup(cur);
 	  assert(sz!=aux.z_hash.empty); // should be in generated partial block
-	  tab_s[i].cross_image = sz; tab_s[sz].cross_image = i;
+	  fields(s,i).cross_image = sz; fields(s,sz).cross_image = i;
 	  assert(length(i)==length(sz)+1);
 	  desc_z.set(s,DescentStatus::ComplexDescent);
 	  assert(descentValue(s,sz)==DescentStatus::ComplexAscent);
@@ -1496,40 +1599,40 @@ param_block::param_block // partial block constructor, for interval below |sr|
 
 	  if (aux.is_real_nonparity(cur,s))
 	  {
-	    tab_s[i].cross_image = i;
+	    fields(s,i).cross_image = i;
 	    desc_z.set(s,DescentStatus::RealNonparity);
 	  }
 	  else // |s| is real parity
 	  {
 	    aux.do_down_Cayley(cur,s);
 	    BlockElt sz = aux.lookup(cur);
-	    tab_s[i].Cayley_image.first = sz; // first inverse Cayley
+	    fields(s,i).Cayley_image.first = sz; // first inverse Cayley
 	    assert(length(i)==length(sz)+1);
 
 	    if (kgb.isDoubleCayleyImage(sub.simple(s),conj_x)) // real type 1
 	    {
 	      desc_z.set(s,DescentStatus::RealTypeI);
 	      assert(descentValue(s,sz)==DescentStatus::ImaginaryTypeI);
-	      tab_s[i].cross_image = i;
-	      tab_s[sz].Cayley_image.first = i; // single-valued Cayley
+	      fields(s,i).cross_image = i;
+	      fields(s,sz).Cayley_image.first = i; // single-valued Cayley
 	      aux.cross_act(cur,s);
 	      sz = aux.lookup(cur);
 	      assert(descentValue(s,sz)==DescentStatus::ImaginaryTypeI);
 	      assert(length(i)==length(sz)+1);
-	      tab_s[i].Cayley_image.second = sz; // second inverse Cayley
-	      tab_s[sz].Cayley_image.first = i;  // single-valued Cayley
+	      fields(s,i).Cayley_image.second = sz; // second inverse Cayley
+	      fields(s,sz).Cayley_image.first = i;  // single-valued Cayley
 	    }
 	    else // real type 2
 	    {
 	      desc_z.set(s,DescentStatus::RealTypeII);
 	      assert(descentValue(s,sz)==DescentStatus::ImaginaryTypeII);
-	      first_free_slot(tab_s[sz].Cayley_image) // double-valued Cayley
+	      first_free_slot(fields(s,sz).Cayley_image) // double-valued Cayley
 		= i;
 	      cur = aux.get(i); // reset to current element
 	      aux.cross_act(cur,s);
 	      BlockElt cross_z = aux.lookup(cur);
 	      if (cross_z!=aux.z_hash.empty) // cross neighbour might be absent
-		tab_s[i].cross_image = cross_z;
+		fields(s,i).cross_image = cross_z;
 	    } // type 2
 	  } // real parity
 
@@ -1543,18 +1646,18 @@ param_block::param_block // partial block constructor, for interval below |sr|
 	  if (kgb.status(sub.simple(s),conj_x)
 	      == gradings::Status::ImaginaryCompact)
 	  { desc_z.set(s,DescentStatus::ImaginaryCompact);
-	    tab_s[i].cross_image = i;
+	    fields(s,i).cross_image = i;
 	  }
 	  else if (kgb.cross(sub.simple(s),conj_x)==conj_x)
 	  { desc_z.set(s,DescentStatus::ImaginaryTypeII);
-	    tab_s[i].cross_image = i;
+	    fields(s,i).cross_image = i;
 	  }
 	  else // imaginary type 1; here |z| has a nontrivial cross action
 	  { desc_z.set(s,DescentStatus::ImaginaryTypeI);
 	    KGBElt cross_x = aux.conj_out_x(kgb.cross(sub.simple(s),conj_x),s);
 	    BlockElt sz=aux.lookup(cross_x,z.y);
 	    if (sz!=aux.z_hash.empty) // cross neighbour might be absent
-	      tab_s[i].cross_image = sz;
+	      fields(s,i).cross_image = sz;
 	  }
 	} // end of imaginary case, and of case distinction
 
@@ -1564,8 +1667,41 @@ param_block::param_block // partial block constructor, for interval below |sr|
   compute_duals(innerClass(),sub);
   compute_y_bits();
 
+  timer.count("elements",this->size());
+  timer.count("y values",ysize());
 } // |param_block::param_block|, partial block version
 
+/*
+  The block structure generated below a parameter depends only on its $x$
+  component and on $\gamma-\lambda$ (which determines $y$ as well as the
+  integral subsystem), so translating $\gamma$ and $\lambda$ by the same
+  integral weight that keeps $\gamma$ dominant gives an isomorphic block, with
+  the same KL polynomials. Only the singular simple roots, the values of
+  $\lambda$ recorded in |y_bits| and the Hermitian duals need to be redone.
+*/
+void param_block::translate(const RatWeight& gamma)
+{
+  assert((gamma-infin_char).normalize().denominator()==1);
+  if (gamma==infin_char)
+    return;
+  const RootDatum& rd = rootDatum();
+  infin_char=gamma;
+
+  const SubSystem sub = SubSystem::integral(rd,infin_char);
+  assert(sub.rank()==rank());
+  for (weyl::Generator s=0; s<sub.rank(); ++s)
+    singular.set(s,rd.coroot(sub.parent_nr_simple(s))
+			    .dot(infin_char.numerator())==0);
+
+  y_bits.clear();
+  compute_y_bits();
+
+  orbits.clear();
+  for (BlockElt z=0; z<size(); ++z)
+    info[z].dual = UndefBlock;
+  compute_duals(innerClass(),sub);
+} // |param_block::translate|
+
 void param_block::compute_y_bits()
 { y_bits.reserve(ysize());
   const InvolutionTable& i_tab = innerClass().involution_table();
@@ -1642,7 +1778,7 @@ DescentStatus descents(KGBElt x, KGBElt y,
   Explanation: technical function for the Hasse construction, that makes the
   part of the coatom list for a given element arising from a given descent.
 */
-void insertAscents(std::set<BlockElt>& hs,
+void insertAscents(set::EltList& hs,
 		   const set::EltList& hr,
 		   size_t s,
 		   const Block_base& block)
@@ -1653,14 +1789,14 @@ void insertAscents(std::set<BlockElt>& hs,
     switch (block.descentValue(s,z))
     {
     case DescentStatus::ComplexAscent:
-      hs.insert(block.cross(s,z));
+      hs.push_back(block.cross(s,z));
       break;
     case DescentStatus::ImaginaryTypeI:
-      hs.insert(block.cayley(s,z).first);
+      hs.push_back(block.cayley(s,z).first);
       break;
     case DescentStatus::ImaginaryTypeII:
-      hs.insert(block.cayley(s,z).first);
-      hs.insert(block.cayley(s,z).second);
+      hs.push_back(block.cayley(s,z).first);
+      hs.push_back(block.cayley(s,z).second);
       break;
     default: // not a strict ascent
       break;
@@ -1677,14 +1813,21 @@ void insertAscents(std::set<BlockElt>& hs,
   seek an ascent s that is complex or type I real. If it exists, use it as in
   kgb. If it doesn't then we're essentially at a split principal series. The
   immediate predecessors of z are just the inverse Cayley transforms.
+
+  The row for |z| only uses rows for elements of length one less, so all
+  elements of one length can be handled in parallel, which |Hasse_filler| does.
 */
-std::vector<set::EltList> makeHasse(const Block_base& block)
+struct Hasse_filler
 {
-  std::vector<set::EltList> result(block.size());
+  const Block_base& block;
+  std::vector<set::EltList>& result;
 
-  for (BlockElt z = 0; z < block.size(); ++z)
+  Hasse_filler(const Block_base& block, std::vector<set::EltList>& result)
+  : block(block), result(result) {}
+
+  void operator() (BlockElt z)
   {
-    std::set<BlockElt> h_z;
+    set::EltList& h_z = result[z];
 
     size_t s=block.firstStrictGoodDescent(z);
     if (s<block.rank())
@@ -1694,25 +1837,43 @@ std::vector<set::EltList> makeHasse(const Block_base& block)
       case DescentStatus::ComplexDescent:
 	{
 	  BlockElt sz = block.cross(s,z);
-	  h_z.insert(sz);
+	  assert(block.length(sz)<block.length(z)); // so is in earlier level
+	  h_z.push_back(sz);
 	  insertAscents(h_z,result[sz],s,block);
 	}
 	break;
       case DescentStatus::RealTypeI: // inverseCayley(s,z) two-valued
 	{
 	  BlockEltPair sz = block.inverseCayley(s,z);
-	  h_z.insert(sz.first);
-	  h_z.insert(sz.second);
+	  assert(block.length(sz.first)<block.length(z));
+	  h_z.push_back(sz.first);
+	  h_z.push_back(sz.second);
 	  insertAscents(h_z,result[sz.first],s,block);
 	}
       }
     else // now just gather all RealTypeII descents of |z|
       for (size_t s = 0; s < block.rank(); ++s)
 	if (block.descentValue(s,z)==DescentStatus::RealTypeII)
-	  h_z.insert(block.inverseCayley(s,z).first);
+	  h_z.push_back(block.inverseCayley(s,z).first);
+
+    std::sort(h_z.begin(),h_z.end()); // make the list sorted and unique
+    h_z.erase(std::unique(h_z.begin(),h_z.end()),h_z.end());
+  }
+}; // |struct Hasse_filler|
 
-    std::copy(h_z.begin(),h_z.end(),std::back_inserter(result[z])); // set->list
-  } // for |z|
+std::vector<set::EltList> makeHasse(const Block_base& block)
+{
+  std::vector<set::EltList> result(block.size());
+  Hasse_filler filler(block,result);
+
+  for (BlockElt z = 0; z < block.size(); ) // block is sorted by length
+  {
+    BlockElt level_end = z;
+    while (level_end<block.size() and block.length(level_end)==block.length(z))
+      ++level_end;
+    parallel::for_each_index(z,level_end,filler);
+    z = level_end;
+  }
 
   return result;
 } // |makeHasse|
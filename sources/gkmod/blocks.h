@@ -15,6 +15,7 @@
 
 #include <cassert>
 #include <iostream>
+#include <vector>
 
 #include "ratvec.h"	// containment infinitesimal character
 
@@ -79,8 +80,10 @@ class Block_base
       : cross_image(UndefBlock), Cayley_image(UndefBlock,UndefBlock) {}
   };
 
+  unsigned int d_rank; // semisimple rank matters
   std::vector<EltInfo> info; // its size defines the size of the block
-  std::vector<std::vector<block_fields> > data;  // size |d_rank| * |size()|
+  // element-major table: the fields for |s| and |z| are at |z*d_rank+s|
+  std::vector<block_fields> data;  // size |d_rank| * |size()|
   ext_gens orbits; // orbits of simple generators under distinguished involution
 
   DynkinDiagram dd;
@@ -88,6 +91,12 @@ class Block_base
   BruhatOrder* d_bruhat;
   kl::KLContext* klc_ptr;
 
+  // the links of |z| for all |s| are adjacent, as the KL recursion wants them
+  block_fields& fields(weyl::Generator s,BlockElt z)
+  { return data[z*d_rank+s]; }
+  const block_fields& fields(weyl::Generator s,BlockElt z) const
+  { return data[z*d_rank+s]; }
+
  public:
 
 // constructors and destructors
@@ -105,7 +114,7 @@ class Block_base
 
 // accessors
 
-  size_t rank() const { return data.size(); } // semisimple rank matters
+  size_t rank() const { return d_rank; }
   size_t folded_rank() const { return orbits.size(); }
   size_t size() const { return info.size(); }
 
@@ -125,19 +134,19 @@ class Block_base
   BlockElt length_first(size_t l) const;
 
   BlockElt cross(weyl::Generator s, BlockElt z) const
-  { assert(z<size()); assert(s<rank()); return data[s][z].cross_image; }
+  { assert(z<size()); assert(s<rank()); return fields(s,z).cross_image; }
 
   BlockEltPair cayley(weyl::Generator s, BlockElt z) const
   { assert(z<size()); assert(s<rank());
     if (not isWeakDescent(s,z))
-      return data[s][z].Cayley_image;
+      return fields(s,z).Cayley_image;
     else return BlockEltPair(UndefBlock,UndefBlock);
   }
 
   BlockEltPair inverseCayley(weyl::Generator s, BlockElt z) const
   { assert(z<size()); assert(s<rank());
     if (isWeakDescent(s,z))
-      return data[s][z].Cayley_image;
+      return fields(s,z).Cayley_image;
     else return BlockEltPair(UndefBlock,UndefBlock);
   }
 
@@ -171,10 +180,13 @@ class Block_base
   virtual std::ostream& print
     (std::ostream& strm, BlockElt z,bool as_invol_expr) const =0;
 
+  size_t memory_use() const; // approximate bytes of tables, including KL data
+
   // manipulators
   BruhatOrder& bruhatOrder() { fillBruhat(); return *d_bruhat; }
   kl::KLContext& klc(BlockElt last_y, bool verbose)
   { fill_klc(last_y,verbose); return *klc_ptr; }
+  kl::KLContext& KL_context(); // created if necessary, maybe not yet filled
 
  private:
   void fillBruhat();
@@ -226,6 +238,11 @@ class Block : public Block_base
   // the main constructor is private to ensure consistency of twists of KGBs
   Block(const KGB& kgb,const KGB& dual_kgb);
 
+  // cache files for the tables the constructor computes from |kgb|, |dual_kgb|
+  std::vector<int> cache_key(const KGB& kgb,const KGB& dual_kgb) const;
+  bool read_cache(const std::vector<int>& key); // whether tables were loaded
+  void write_cache(const std::vector<int>& key) const;
+
  public:
   // use one of the following two pseudo contructors to build |Block| values
   static Block build // pseudo contructor with small (and forgotten) KGB sets
@@ -325,6 +342,10 @@ class param_block : public Block_base
   // auxiliary for construction
   void compute_duals(const InnerClass& G,const SubSystem& rs);
 
+  // move to infinitesimal character |gamma|, which must differ from |gamma()|
+  // by an integral weight and be dominant; elements and KL data are unchanged
+  void translate(const RatWeight& gamma);
+
  public:
   // accessors that get values via |rc|
   const repr::Rep_context& context() const { return rc; }
@@ -14,6 +14,9 @@
 
 #include "bruhat.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace atlas {
 
 
@@ -25,6 +28,13 @@ namespace atlas {
 
 namespace bruhat {
 
+namespace {
+
+  // number of traversals labelling elements; each makes |lesseq| prune more
+  const unsigned int n_labellings = 3;
+
+} // |namespace|
+
 
 /*!
   \brief Computes the full poset from the stored Hasse diagram.
@@ -35,6 +45,138 @@ void BruhatOrder::fillPoset()
     poset::Poset(d_hasse).swap(d_poset);
 }
 
+/*!
+  \brief Tests whether |x<=y| in the order.
+
+  If the full poset was computed, it is used. Otherwise a depth-first search
+  downwards from |y| through the Hasse diagram is done, which is pruned at
+  elements |z| with |z<x| (which cannot lie above |x|) and at those whose
+  interval labels exclude |x| lying below them. Most incomparable pairs are
+  rejected by the labels of |y| right away.
+*/
+bool BruhatOrder::lesseq(set::Elt x, set::Elt y)
+{
+  if (x>=y)
+    return x==y;
+  if (d_poset.size()>0)
+    return d_poset.lesseq(x,y);
+
+  fillIntervals();
+  if (not may_lie_below(x,y))
+    return false;
+
+  if (++d_search==0) // after wrap-around of counter, old marks are a nuisance
+  {
+    std::fill(d_mark.begin(),d_mark.end(),0);
+    d_search=1;
+  }
+
+  std::vector<set::Elt> stack(1,y); d_mark[y]=d_search;
+  while (not stack.empty())
+  {
+    const set::EltList& below=d_hasse[stack.back()];
+    stack.pop_back();
+    for (set::EltList::const_iterator it=below.begin(); it!=below.end(); ++it)
+      if (*it==x)
+	return true;
+      else if (*it>x and d_mark[*it]!=d_search and may_lie_below(x,*it))
+      {
+	d_mark[*it]=d_search;
+	stack.push_back(*it);
+      }
+  }
+  return false;
+}
+
+/*!
+  \brief Computes the interval labels, unless already done.
+
+  Traversal |k| visits the covered elements of each element in a different
+  order (forward, backward, and rotated), which makes the labellings
+  differ, so that together they exclude more pairs. The traversals are done
+  with an explicit stack, since chains in the order may be long.
+*/
+void BruhatOrder::fillIntervals()
+{
+  const size_t n=size();
+  if (d_interval.size()>0 or n==0)
+    return;
+
+  std::vector<bool> covered(n,false); // whether any element lies above
+  for (size_t y=0; y<n; ++y)
+    for (size_t i=0; i<d_hasse[y].size(); ++i)
+      covered[d_hasse[y][i]]=true;
+
+  std::vector<unsigned int> interval(2*n_labellings*n);
+  for (unsigned int k=0; k<n_labellings; ++k)
+  {
+    std::vector<bool> seen(n,false);
+    unsigned int post=0;
+
+    // stack of pairs of an element and the number of its children handled
+    std::vector<std::pair<set::Elt,size_t> > stack;
+    for (size_t r=0; r<n; ++r)
+    {
+      const set::Elt root = k%2==0 ? r : n-1-r;
+      if (covered[root])
+	continue;
+      seen[root]=true;
+      interval[2*(n_labellings*root+k)]=
+	std::numeric_limits<unsigned int>::max();
+      stack.push_back(std::make_pair(root,0));
+      while (not stack.empty())
+      {
+	const set::Elt v = stack.back().first;
+	const set::EltList& below=d_hasse[v];
+	unsigned int& low=interval[2*(n_labellings*v+k)];
+	size_t& i = stack.back().second;
+	if (i<below.size())
+	{
+	  const size_t m=below.size();
+	  const set::Elt c = below[k==0 ? i : k==1 ? m-1-i : (i+v)%m];
+	  ++i;
+	  if (not seen[c])
+	  {
+	    seen[c]=true;
+	    interval[2*(n_labellings*c+k)]=
+	      std::numeric_limits<unsigned int>::max();
+	    stack.push_back(std::make_pair(c,0)); // invalidates |i|
+	  }
+	  else // |c| was done, since the order has no cycles
+	    low=std::min(low,interval[2*(n_labellings*c+k)]);
+	}
+	else // all elements below |v| are done; finish |v|
+	{
+	  interval[2*(n_labellings*v+k)+1]=post;
+	  low=std::min(low,post++);
+	  stack.pop_back();
+	  if (not stack.empty()) // pass |low| up to the element above |v|
+	  {
+	    unsigned int& parent_low
+	      = interval[2*(n_labellings*stack.back().first+k)];
+	    parent_low=std::min(parent_low,low);
+	  }
+	}
+      }
+    }
+  }
+
+  d_mark.assign(n,0);
+  d_interval.swap(interval); // commit
+}
+
+bool BruhatOrder::may_lie_below(set::Elt x, set::Elt y) const
+{
+  for (unsigned int k=0; k<n_labellings; ++k)
+  {
+    const unsigned int* lx = &d_interval[2*(n_labellings*x+k)];
+    const unsigned int* ly = &d_interval[2*(n_labellings*y+k)];
+    if (lx[0]<ly[0] or lx[1]>ly[1])
+      return false;
+  }
+  return true;
+}
+
 } // |namespace bruhat|
 
 } // |namespace atlas|
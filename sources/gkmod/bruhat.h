@@ -15,6 +15,9 @@
 #ifndef BRUHAT_H  /* guard against multiple inclusions */
 #define BRUHAT_H
 
+#include <vector>
+#include <utility> // for |std::move|
+
 #include "poset.h"	// containment
 
 namespace atlas {
@@ -32,7 +35,9 @@ namespace bruhat {
   on a block of representations.
 
   In fact just stores any given relation as the Hasse diagram, and is capable
-  of expanding the full poset by transitivity.
+  of expanding the full poset by transitivity. Since that poset takes memory
+  quadratic in the size, individual relations can also be tested by |lesseq|,
+  which uses only the Hasse diagram and an index of linear size.
 */
 class BruhatOrder
 {
@@ -51,11 +56,25 @@ only if i < j.
   */
   poset::Poset d_poset;
 
+  /*!
+\brief Interval labels, for |lesseq| without |d_poset|.
+
+For each of |n_labellings| depth-first traversals of the Hasse diagram
+downwards from the maximal elements, element \#j gets the pair (low,post)
+where post is its number in post-order and low the minimal such number of
+any element below it. If \#i is below \#j, then the interval of \#i is
+contained in that of \#j for every traversal.
+  */
+  std::vector<unsigned int> d_interval;
+  std::vector<unsigned int> d_mark; // visited marks for searches by |lesseq|
+  unsigned int d_search; // number of the current search, used as mark
+
  public:
 
 // constructors and destructors
-  explicit BruhatOrder(const std::vector<set::EltList>& Hasse_diagram)
-    : d_hasse(Hasse_diagram), d_poset(0) {}
+  explicit BruhatOrder(std::vector<set::EltList> Hasse_diagram)
+    : d_hasse(std::move(Hasse_diagram)), d_poset(0)
+    , d_interval(), d_mark(), d_search(0) {}
 
 
 // accessors
@@ -83,8 +102,15 @@ only if i < j.
     fillPoset(); return d_poset;
   }
 
+  // whether |x<=y|; uses |d_poset| if present, never generates it
+  bool lesseq(set::Elt x, set::Elt y);
+
   private:
   void fillPoset();
+  void fillIntervals();
+
+  // whether interval labels allow element |x| to lie below |y|
+  bool may_lie_below(set::Elt x, set::Elt y) const;
 
 }; // |class BruhatOrder|
 
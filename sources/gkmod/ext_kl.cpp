@@ -9,6 +9,8 @@
 
 #include "ext_kl.h"
 #include "basic_io.h"
+#include "parallel.h"
+#include "profile.h"
 
 namespace atlas {
 namespace ext_kl {
@@ -19,9 +21,10 @@ public:
   // constructors
   PolEntry() : Pol() {} // default constructor builds zero polynomial
   PolEntry(const Pol& p) : Pol(p) {} // lift polynomial to this class
+  PolEntry(PolRef p) : Pol(p) {} // copy polynomial from storage
 
   // members required for an Entry parameter to the HashTable template
-  typedef std::vector<Pol> Pooltype;  // associated storage type
+  typedef PolStore Pooltype;  // associated storage type
   size_t hashCode(size_t modulus) const; // hash function
 
   // compare polynomial with one from storage
@@ -140,9 +143,9 @@ bool descent_table::extr_back_up(BlockElt& x, BlockElt y) const
   return false;
 } // |descent_table::extr_back_up|
 
-KL_table::KL_table(const ext_block::ext_block& b, std::vector<Pol>& pool)
+KL_table::KL_table(const ext_block::ext_block& b, PolStore& pool)
   : aux(b), storage_pool(pool), column()
-  , untwisted(b.untwisted())
+  , untwisted()
 { // ensure first two pool entries are constant polynomials $0$, and $1$
   if (pool.empty())
     pool.push_back(Pol(0));
@@ -154,7 +157,8 @@ KL_table::KL_table(const ext_block::ext_block& b, std::vector<Pol>& pool)
     assert(pool[1]==Pol(1));
 
 #ifndef NDEBUG
-  untwisted.fill(false);
+  untwisted.reset(new kl::KLContext(b.untwisted()));
+  untwisted->fill(false);
 #endif
 }
 
@@ -173,7 +177,8 @@ KL_table::KL_pol_index(BlockElt x, BlockElt y) const
 Pol KL_table::P(BlockElt x, BlockElt y) const
 {
   auto index = KL_pol_index(x,y);
-  return index.second ? -storage_pool[index.first] : storage_pool[index.first];
+  Pol result = storage_pool[index.first];
+  return index.second ? -result : result;
 }
 
 // coefficient of P_{x,y} of $q^{(l(y/x)-i)/2}$ (used with i=1,2,3 only)
@@ -185,7 +190,7 @@ int KL_table::mu(int i,BlockElt x, BlockElt y) const
   if (d%2!=0)
     return 0; // coefficient would be at non-integral degree
   d/=2;
-  PolRef Pxy=P(x,y);
+  const Pol Pxy=P(x,y);
   return Pxy.degree_less_than(d) ? 0 : Pxy[d];
 }
 
@@ -429,14 +434,58 @@ bool KL_table::has_direct_recursion(BlockElt y,
 }
 
 
+// The function object passed to |parallel::for_each_index| by |fill_columns|
+struct KL_table::Column_filler
+{
+  KL_table& table;
+  PolHash& hash;
+  Column_filler(KL_table& table, PolHash& hash) : table(table), hash(hash) {}
+  void operator() (size_t y) { table.fill_column(y,hash); }
+}; // |struct KL_table::Column_filler|
+
+/*
+  Columns are filled one length at a time. Those of the same length only
+  depend on columns for shorter elements, so they can be computed by several
+  threads at once, which share a hash table for the polynomials. Afterwards
+  the new polynomials are renumbered to the order in which a sequential
+  computation would have found them, so results do not depend on timing: such
+  a computation calls |hash.match| for the entries of each column in
+  decreasing order, so we number new polynomials by their first occurrence
+  when traversing columns in that manner.
+*/
 void KL_table::fill_columns(BlockElt y)
 {
+  profile::phase timer("ext KL polynomials");
   PolHash hash(storage_pool); // (re)construct hash table for the polynomials
   if (y==0 or y>aux.block.size())
     y=aux.block.size(); // fill whole block if no explicit stop was indicated
+  const BlockElt old_columns = column.size();
+  const kl::KLIndex old_polys = storage_pool.size();
   column.reserve(y);
   while (column.size()<y)
-    fill_next_column(hash);
+  {
+    const BlockElt y_begin = column.size();
+    BlockElt y_end = aux.block.length_first(aux.block.length(y_begin)+1);
+    if (y_end>y)
+      y_end = y;
+    const kl::KLIndex first_new = storage_pool.size();
+    column.resize(y_end); // columns of this length are filled in place
+    try
+    {
+      Column_filler filler(*this,hash);
+      parallel::for_each_index(y_begin,y_end,filler);
+    }
+    catch (...)
+    {
+      column.resize(y_begin); // forget partially filled columns
+      throw;
+    }
+    if (parallel::thread_count()>1)
+      hash.renumber_by_use
+	(first_new,column.begin()+y_begin,column.begin()+y_end);
+  }
+  timer.count("columns",column.size()-old_columns);
+  timer.count("polynomials",storage_pool.size()-old_polys);
 }
 
 /*
@@ -500,13 +549,11 @@ Pol KL_table::extract_M(Pol& Q,unsigned d,unsigned defect) const
   return M;
 } // |KL_table::extract_M|
 
-void KL_table::fill_next_column(PolHash& hash)
+void KL_table::fill_column(BlockElt y, PolHash& hash)
 {
-  const BlockElt y = column.size();
-  column.push_back(kl::KLRow());
   if (aux.col_size(y)==0)
     return; // there is just the non-recorded $P(y,y)=1$
-  column.back().resize(aux.col_size(y));
+  column[y].resize(aux.col_size(y));
 
   weyl::Generator s;
   BlockElt sy;
@@ -554,7 +601,7 @@ void KL_table::fill_next_column(PolHash& hash)
       } // |for(u)|
 
     // finally copy relevant coefficients from |cy| array to |column[y]|
-    kl::KLRow::reverse_iterator it = column.back().rbegin();
+    kl::KLRow::reverse_iterator it = column[y].rbegin();
     for (BlockElt x=floor_y; aux.prim_back_up(x,y); it++)
       if (aux.descent_set(x)[s]) // then we computed $P(x,y)$ above
         *it = hash.match(cy[x]*sign);
@@ -571,13 +618,13 @@ void KL_table::fill_next_column(PolHash& hash)
 	  Q -= P(sx.second,y);
         *it = hash.match(Q);
       }
-    assert(it==column.back().rend()); // check that we've traversed the column
+    assert(it==column[y].rend()); // check that we've traversed the column
   }
   else // direct recursion was not possible
     do_new_recursion(y,hash);
 
   assert(check_polys(y));
- } // |KL_table::fill_next_column|
+ } // |KL_table::fill_column|
 
 /*
   Basic idea for new recursion: if some $s$ is real nonparity for $y$ and a
@@ -596,7 +643,7 @@ void KL_table::do_new_recursion(BlockElt y,PolHash& hash)
 {
   const BlockElt floor_y =aux.length_floor(y);
   std::vector<PolEntry> cy(floor_y,(PolEntry()));
-  kl::KLRow::iterator out_it = column.back().end();
+  kl::KLRow::iterator out_it = column[y].end();
   std::vector<weyl::Generator> rn_s; rn_s.reserve(rank());
   std::vector<std::vector<Pol> > M_s; M_s.reserve(rank());
   for (weyl::Generator s=0; s<rank(); ++s)
@@ -798,7 +845,7 @@ void KL_table::do_new_recursion(BlockElt y,PolHash& hash)
 } // |KL_table::do_new_recursion|
 
 
-bool check(const Pol& P_sigma, const KLPol& P)
+bool check(const Pol& P_sigma, kl::KLPolRef P)
 {
   if (P_sigma.isZero())
   { if (P.isZero())
@@ -823,12 +870,13 @@ bool KL_table::check_polys(BlockElt y) const
 {
   bool result = true;
   for (BlockElt x=y; x-->0; )
-    if (not check(P(x,y),untwisted.klPol(aux.block.z(x),aux.block.z(y))))
+    if (not check(P(x,y),untwisted->klPol(aux.block.z(x),aux.block.z(y))))
     {
       std::cerr << "Mismatch at (" << aux.block.z(x) << ',' << aux.block.z(y)
 		<< "): ";
       std::cerr << P(x,y) << " and "
-		<< untwisted.klPol(aux.block.z(x),aux.block.z(y)) << std::endl;
+		<< KLPol(untwisted->klPol(aux.block.z(x),aux.block.z(y)))
+		<< std::endl;
       result=false;
     }
   return result;
@@ -852,19 +900,20 @@ void ext_KL_matrix (const StandardRepr p, const int_Matrix& delta,
   BlockElt size= // size of extended block we shall use; before compression
     eblock.element(entry_element+1);
 
-  std::vector<ext_kl::Pol> pool;
+  ext_kl::PolStore pool;
   KL_table twisted_KLV(eblock,pool);
   twisted_KLV.fill_columns(size); // fill up to and including |p|
 
   int_Vector pol_value (pool.size());
-  for (auto it=pool.begin(); it!=pool.end(); ++it)
-    if (it->isZero())
-      pol_value[it-pool.begin()]=0;
+  for (size_t i=0; i<pool.size(); ++i)
+    if (pool[i].isZero())
+      pol_value[i]=0;
     else
-    { int sum=(*it)[it->degree()];
-      for (auto d=it->degree(); d-->0; )
-	sum=(*it)[d]-sum;
-      pol_value[it-pool.begin()]=sum;
+    { const PolRef P = pool[i];
+      int sum=P[P.degree()];
+      for (auto d=P.degree(); d-->0; )
+	sum=P[d]-sum;
+      pol_value[i]=sum;
     }
 
   P_mat = int_Matrix(size);
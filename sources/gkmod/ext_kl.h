@@ -10,17 +10,22 @@
 #ifndef EXT_KL_H  /* guard against multiple inclusions */
 #define EXT_KL_H
 
+#include <memory> // for |std::unique_ptr|
+
 #include "ext_block.h"
 #include "../Atlas.h"
 #include "polynomials.h"
-#include "kl.h" // for (temporary) inclusion of |kl::KLContext| in |KL_table|
+#include "poly_store.h"
+#include "concurrent_hashtable.h"
+#include "kl.h" // for |kl::KLContext| used to check results when debugging
 
 namespace atlas {
 
 namespace ext_kl {
 
 typedef Polynomial<int> Pol;
-typedef const Pol& PolRef;
+typedef polynomials::Poly_ref<int> PolRef;
+typedef polynomials::Poly_store<int> PolStore;
 
 Pol qk_plus_1(int k);
 inline Pol q_plus_1() { return qk_plus_1(1); }
@@ -71,15 +76,15 @@ class PolEntry; // class definition will be given in the implementation file
 class KL_table
 {
   const descent_table aux;
-  std::vector<Pol>& storage_pool; // the distinct actual polynomials
+  PolStore& storage_pool; // the distinct actual polynomials
 
   std::vector<kl::KLRow> column; // columns are lists of polynomial pointers
 
-  //TEMPORARY
-  kl::KLContext untwisted;
+  // untwisted KL polynomials, only computed when debugging to check ours
+  std::unique_ptr<kl::KLContext> untwisted;
 
  public:
-  KL_table(const ext_block::ext_block& b, std::vector<Pol>& pool);
+  KL_table(const ext_block::ext_block& b, PolStore& pool);
 
   size_t rank() const { return aux.block.rank(); }
   size_t size() const { return column.size(); }
@@ -102,8 +107,10 @@ class KL_table
   // manipulator
   void fill_columns(BlockElt y=0);
  private:
-  typedef HashTable<PolEntry,kl::KLIndex> PolHash;
-  void fill_next_column(PolHash& hash);
+  typedef hashtable::ConcurrentHashTable<PolEntry,kl::KLIndex> PolHash;
+  struct Column_filler; // function object to fill columns, possibly in threads
+
+  void fill_column(BlockElt y, PolHash& hash);
 
   // component of basis element $a_x$ in product $(T_s+1)C_{sy}$
   Pol product_comp (BlockElt x, weyl::Generator s, BlockElt sy) const;
@@ -21,6 +21,8 @@
 #include "kgb.h"
 
 #include <cassert>
+#include <fstream>
+#include <sstream>
 #include <map>
 #include <memory>
 #include <set>
@@ -40,8 +42,10 @@
 #include "tits.h"
 #include "weyl.h"
 #include "involutions.h" // for |InvolutionTable|
+#include "parallel.h" // for |makeHasse|
+#include "profile.h"
 
-#include "basic_io.h"
+#include "basic_io.h"	// for binary cache files
 #include "prettyprint.h"
 #include "ioutils.h"
 
@@ -65,6 +69,10 @@ namespace {
 
 void makeHasse(std::vector<set::EltList>&, const KGB_base&);
 
+  std::string KGB_cache_directory; // where KGB sets and blocks are cached
+  const unsigned int cache_magic=0x43424741; // "AGBC" in little-endian
+  const int KGB_cache_format=2; // increase when the file format changes
+
 } // |namespace|
 
 
@@ -138,6 +146,31 @@ size_t KGB_base::packet_size(const TwistedInvolution& w) const
   return first_of_tau[i+1]-first_of_tau[i];
 }
 
+/*
+  A hash of the link tables, statuses, Hermitian duals and involutions. Two
+  KGB sets with equal signature can be taken to be the same, with the same
+  numbering; a block built from them is then the same as well.
+*/
+unsigned long long KGB_base::signature() const
+{
+  unsigned long long result=size();
+  for (inv_index i=0; i<nr_involutions(); ++i)
+  {
+    const WeylWord ww = weylGroup().word(nth_involution(i).w());
+    result = result*1000003 + first_of_tau[i+1];
+    for (size_t j=0; j<ww.size(); ++j)
+      result = result*31 + ww[j];
+  }
+  for (KGBElt x=0; x<size(); ++x)
+  {
+    for (weyl::Generator s=0; s<rank(); ++s)
+      result = ((result*1000003 + cross(s,x))*1000003 + cayley(s,x))*4
+	+ status(s,x);
+    result = result*1000003 + Hermitian_dual(x);
+  }
+  return result;
+}
+
 // compute Cartan class with aid of |ic.involution_table()|
 CartanNbr KGB_base::Cartan_class(KGBElt x) const
 { // compute passing by involution index, |InvolutionNbr|
@@ -353,8 +386,62 @@ void global_KGB::generate_involutions(size_t num_inv)
   assert(inv_nrs.size()==num_inv);
 } // |global_KGB::generate_involutions|
 
+/*
+  Cross action and Cayley transform of one element by one simple reflection,
+  with the packed forms needed for lookup. These are computed concurrently for
+  all elements of a range, after which the lookups are done one by one, in the
+  order that a sequential pass would use, so that numbering is unaffected.
+*/
+struct global_KGB::Link_images
+{
+  GlobalTitsElement cross, Cayley; // the latter only set if |noncompact|
+  KGB_elt_entry cross_entry, Cayley_entry; // their packed forms
+  int d; // length difference of cross action
+  bool noncompact; // whether |s| is imaginary noncompact
+
+  Link_images(const GlobalTitsElement& a)
+  : cross(a), Cayley(a)
+  , cross_entry(RatWeight(0),a), Cayley_entry(RatWeight(0),a)
+  , d(0), noncompact(false) {}
+}; // |struct global_KGB::Link_images|
+
+// The function object passed to |parallel::for_each_index| by |generate|
+struct global_KGB::Link_finder
+{
+  const global_KGB& kgb;
+  weyl::Generator s;
+  KGBElt first; // element corresponding to index 0
+  std::vector<Link_images>& dest;
+  Link_finder(const global_KGB& kgb, weyl::Generator s, KGBElt first,
+	      std::vector<Link_images>& dest)
+  : kgb(kgb), s(s), first(first), dest(dest) {}
+  void operator() (size_t i);
+}; // |struct global_KGB::Link_finder|
+
+void global_KGB::Link_finder::operator() (size_t i)
+{
+  const Cartan_orbits& i_tab = kgb.ic.involution_table();
+  const GlobalTitsElement& x = kgb.elt[first+i];
+  Link_images& dst = dest[i];
+
+  dst.cross = x;
+  dst.d = kgb.Tg.cross_act(s,dst.cross);
+  dst.cross_entry = i_tab.x_pack(dst.cross);
+
+  dst.noncompact = // imaginary: twisted conjugation stable, and no descent
+    dst.cross.tw()==x.tw() and not kgb.Tg.hasDescent(s,x.tw())
+    and not x.torus_part().negative_at(kgb.rootDatum().simpleRoot(s));
+  if (dst.noncompact)
+  {
+    dst.Cayley = kgb.Tg.Cayley(s,x);
+    dst.Cayley_entry = i_tab.x_pack(dst.Cayley);
+  }
+} // |global_KGB::Link_finder::operator()|
+
 void global_KGB::generate(size_t predicted_size, bool dual_twist)
 {
+  profile::phase timer("global KGB");
+  const KGBElt old_size = elt.size();
   const Cartan_orbits& i_tab = ic.involution_table();
   const TwistedWeylGroup& W = Tg; // for when |GlobalTitsGroup| is not used
 
@@ -376,6 +463,15 @@ void global_KGB::generate(size_t predicted_size, bool dual_twist)
     end_length = first_of_tau.size()-1; // and run until current end
 
     for (weyl::Generator s=0; s<W.rank(); ++s)
+    {
+      // the elements of the interval are fixed; find their links concurrently
+      const KGBElt first = first_of_tau[start_length];
+      std::vector<Link_images> links;
+      if (first<first_of_tau[end_length])
+	links.assign(first_of_tau[end_length]-first,Link_images(elt[first]));
+      Link_finder finder(*this,s,first,links);
+      parallel::for_each_index(0,links.size(),finder);
+
       for (inv_index index=start_length; index<end_length; ++index)
       {
 	const TwistedInvolution& tw = nth_involution(index);
@@ -392,11 +488,10 @@ void global_KGB::generate(size_t predicted_size, bool dual_twist)
 	// generate cross links
 	for (KGBElt x=first_of_tau[index]; x<first_of_tau[index+1]; ++x)
 	{
-	  GlobalTitsElement child=elt[x]; //start out with a copy
-	  int d = Tg.cross_act(s,child); // cross act; |d| is length difference
+	  const GlobalTitsElement& child=links[x-first].cross;
+	  int d = links[x-first].d; // length difference of cross action
 	  assert(child.tw()==new_tw);
-	  KGB_elt_entry ee = i_tab.x_pack(child);
-	  KGBElt k = elt_hash.match(ee);
+	  KGBElt k = elt_hash.match(links[x-first].cross_entry);
 	  if (k==elt.size()) // then new
 	  {
 	    assert(is_new);
@@ -414,8 +509,7 @@ void global_KGB::generate(size_t predicted_size, bool dual_twist)
 	  else if (imaginary)
 	  {
 	    info[x].status.set_imaginary // always true (noncompact) at identity
-	      (s,
-	       not elt[x].torus_part().negative_at(rootDatum().simpleRoot(s)));
+	      (s,links[x-first].noncompact);
 	    info[x].desc.set(s,false); // imaginary roots are never descents
 	  }
 	  else // real
@@ -438,9 +532,9 @@ void global_KGB::generate(size_t predicted_size, bool dual_twist)
 	  for (KGBElt x=first_of_tau[index]; x<first_of_tau[index+1]; ++x)
 	    if (info[x].status[s]==gradings::Status::ImaginaryNoncompact)
 	    {
-	      GlobalTitsElement child=Tg.Cayley(s,elt[x]);
+	      const GlobalTitsElement& child=links[x-first].Cayley;
 	      assert(child.tw()==new_tw);
-	      KGBElt k=elt_hash.match(i_tab.x_pack(child));
+	      KGBElt k=elt_hash.match(links[x-first].Cayley_entry);
 	      if (k==elt.size()) // then new
 	      {
 		elt.push_back(child);
@@ -459,7 +553,8 @@ void global_KGB::generate(size_t predicted_size, bool dual_twist)
 	  first_of_tau.push_back(elt.size()); // close the tau packet
 
 
-      } // |for(index)|;  // |for(s)|
+      } // |for(index)|
+    } // |for(s)|
   } // while length interval non-empty
 
   assert(elt.size()==predicted_size or predicted_size==0);
@@ -468,6 +563,8 @@ void global_KGB::generate(size_t predicted_size, bool dual_twist)
   for (KGBElt i=0; i<elt.size(); ++i)
     info[i].dual = lookup
       (dual_twist ? Tg.dual_twisted(elt[i]) : Tg.twisted(elt[i]));
+
+  timer.count("elements",elt.size()-old_size);
 } // |global_KGB::generate|
 
 
@@ -478,6 +575,68 @@ void global_KGB::generate(size_t predicted_size, bool dual_twist)
 
 */
 
+/*
+  Cross action and Cayley transform of one element by one simple reflection,
+  reduced but not yet looked up. As for |global_KGB|, these are computed
+  concurrently for a range of elements, and then looked up in the order of a
+  sequential pass, so that numbering is unaffected.
+*/
+struct KGB::Link_images
+{
+  TitsElt cross, Cayley; // the latter only set if |noncompact|
+  int lc; // length change of cross action
+  bool real; // whether |s| is real (if |lc==0|)
+  bool noncompact; // whether |s| is imaginary noncompact (if |lc==0|)
+
+  Link_images(const TitsElt& a)
+  : cross(a), Cayley(a), lc(0), real(false), noncompact(false) {}
+}; // |struct KGB::Link_images|
+
+// The function object passed to |parallel::for_each_index| by the constructor
+struct KGB::Link_finder
+{
+  const KGB& kgb;
+  const tits::TE_Entry::Pooltype& pool; // the elements found so far
+  KGBElt first; // element corresponding to index 0
+  std::vector<Link_images>& dest; // |rank()| consecutive entries per element
+  Link_finder(const KGB& kgb, const tits::TE_Entry::Pooltype& pool,
+	      KGBElt first, std::vector<Link_images>& dest)
+  : kgb(kgb), pool(pool), first(first), dest(dest) {}
+  void operator() (size_t i);
+}; // |struct KGB::Link_finder|
+
+void KGB::Link_finder::operator() (size_t i)
+{
+  const Cartan_orbits& i_tab = kgb.ic.involution_table();
+  const TitsCoset& Tc = kgb.basedTitsGroup();
+  const WeylGroup& W = kgb.weylGroup();
+  const TitsElt& current = pool[first+i];
+
+  for (weyl::Generator s=0; s<kgb.rank(); ++s)
+  {
+    Link_images& dst = dest[i*kgb.rank()+s];
+    TitsElt& a = dst.cross;
+    a = current; Tc.basedTwistedConjugate(a,s);
+    i_tab.reduce(a);
+
+    dst.lc= a.tw()==current.tw() ? 0 : W.length_change(s,current.w());
+    if (dst.lc!=0)
+      continue; // complex
+    dst.real = W.hasDescent(s,current.w());
+    if (dst.real)
+      continue;
+    dst.noncompact = Tc.simple_grading(current,s);
+    if (dst.noncompact)
+    {
+      // Cayley-transform |current| by $\sigma_s$
+      dst.Cayley = current; Tc.Cayley_transform(dst.Cayley,s);
+      assert(kgb.titsGroup().length(dst.Cayley)>
+	     kgb.titsGroup().length(current));
+      i_tab.reduce(dst.Cayley); // subspace has grown, mod out new subspace
+    }
+  }
+} // |KGB::Link_finder::operator()|
+
 KGB::KGB(RealReductiveGroup& G,
 	 const BitMap& Cartan_classes, bool dual_twist)
   : KGB_base(G.innerClass(),G.innerClass().semisimpleRank())
@@ -488,6 +647,7 @@ KGB::KGB(RealReductiveGroup& G,
   , d_bruhat(NULL)
   , d_base(NULL)
 {
+  profile::phase timer("KGB");
   //const TitsGroup& Tg = ic.titsGroup();
   size_t rank = ic.semisimpleRank(); // |ic.rank()| does not interest us here
 
@@ -543,68 +703,77 @@ KGB::KGB(RealReductiveGroup& G,
     } // |for (it)|
   }
 
-  // now inductively fill the table |elt_pool|/|elt_hash|, and related arrays
-  for (KGBElt x=0; x<elt_hash.size(); ++x) // loop makes |elt_hash| grow
+  const std::vector<int> key = cache_key(Cartan_classes,dual_twist);
+  if (read_cache(key,Cartan_classes)) // then tables were installed from a file
   {
-    // extend by cross actions
-    const TitsElt& current = elt_pool[x];
-    EltInfo& my_info = info[x];
+    timer.count("elements",this->size());
+    timer.count("read from cache");
+    return;
+  }
 
-    for (weyl::Generator s=0; s<rank; ++s)
+  /* now inductively fill the table |elt_pool|/|elt_hash|, and related arrays.
+     Elements are handled in batches: the links of a batch are found in
+     parallel, then looked up in |elt_hash| in order, which may extend it */
+  const size_t batch_size = 0x400*parallel::thread_count();
+  std::vector<Link_images> links;
+  for (KGBElt begin=0; begin<elt_hash.size(); ) // loop makes |elt_hash| grow
+  {
+    const KGBElt end = std::min<size_t>(elt_hash.size(),begin+batch_size);
+    links.assign((end-begin)*rank,Link_images(elt_pool[begin]));
+    Link_finder finder(*this,elt_pool,begin,links);
+    parallel::for_each_index(0,end-begin,finder);
+
+    for (KGBElt x=begin; x<end; ++x)
     {
-      KGBfields& my_s = data[s][x];
-      TitsElt a = current; basedTitsGroup().basedTwistedConjugate(a,s);
-      i_tab.reduce(a);
+      EltInfo& my_info = info[x];
 
-      int lc=
-	a.tw()==current.tw() ? 0 : weylGroup().length_change(s,current.w());
+      for (weyl::Generator s=0; s<rank; ++s)
+      {
+	KGBfields& my_s = data[s][x];
+	const Link_images& l = links[(x-begin)*rank+s];
 
-      // now find the Tits element in |elt_hash|, or add it if new
-      KGBElt child = elt_hash.match(a);
-      if (child==info.size()) // add a new Tits element
-	KGB_base::add_element();
+	// now find the Tits element in |elt_hash|, or add it if new
+	KGBElt child = elt_hash.match(l.cross);
+	if (child==info.size()) // add a new Tits element
+	  KGB_base::add_element();
 
-      // set cross link for |x|
-      my_s.cross_image = child;
+	// set cross link for |x|
+	my_s.cross_image = child;
 
-      if (lc!=0) // then set complex status, and whether ascent or descent
-      {
-	my_info.status.set(s,gradings::Status::Complex);
-	my_info.desc.set(s,lc<0);
-      }
-      else if (weylGroup().hasDescent(s,current.w())) // real
-      {
-	assert(child==x);
-	my_info.status.set(s,gradings::Status::Real);
-	my_info.desc.set(s); // real roots are always descents
-      }
-      else // imaginary
-      {
-	my_info.status.set_imaginary
-	  (s,basedTitsGroup().simple_grading(current,s));
-	my_info.desc.reset(s); // imaginary roots are never (KGB) descents
-
-	if (my_info.status[s] == gradings::Status::ImaginaryNoncompact)
+	if (l.lc!=0) // then set complex status, and whether ascent or descent
+	{
+	  my_info.status.set(s,gradings::Status::Complex);
+	  my_info.desc.set(s,l.lc<0);
+	}
+	else if (l.real)
 	{
-	  // Cayley-transform |current| by $\sigma_s$
-	  TitsElt a = current; basedTitsGroup().Cayley_transform(a,s);
-	  assert(titsGroup().length(a)>titsGroup().length(current));
-	  i_tab.reduce(a); // subspace has grown, mod out new subspace
+	  assert(child==x);
+	  my_info.status.set(s,gradings::Status::Real);
+	  my_info.desc.set(s); // real roots are always descents
+	}
+	else // imaginary
+	{
+	  my_info.status.set_imaginary(s,l.noncompact);
+	  my_info.desc.reset(s); // imaginary roots are never (KGB) descents
 
-	  KGBElt child = elt_hash.match(a);
-	  if (child==info.size()) // add a new Tits element
-	    KGB_base::add_element();
+	  if (l.noncompact)
+	  {
+	    KGBElt child = elt_hash.match(l.Cayley);
+	    if (child==info.size()) // add a new Tits element
+	      KGB_base::add_element();
 
-	  // add new Cayley link
-	  my_s.Cayley_image = child;
+	    // add new Cayley link
+	    my_s.Cayley_image = child;
 
-	} // if |ImaginaryNoncompact|
+	  } // if |ImaginaryNoncompact|
 
-      } // complex/real/imaginary disjunction
+	} // complex/real/imaginary disjunction
 
-    } // |for(s)|
+      } // |for(s)|
 
-  } // |for (x)|
+    } // |for (x)|
+    begin=end;
+  } // |for (begin)|
 
   assert(KGB_base::size()==size);
 
@@ -689,6 +858,10 @@ KGB::KGB(RealReductiveGroup& G,
     else
       info[x].dual = UndefKGB;
   }
+
+  write_cache(key); // does nothing unless caching is enabled
+  timer.count("elements",this->size());
+  timer.count("involutions",nr_involutions());
 } // |KGB::KGB(G,Cartan_classes,i_tab)|
 
 
@@ -804,7 +977,7 @@ void KGB::fillBruhat()
     return;
 
   std::vector<set::EltList> hd; makeHasse(hd,*this);
-  BruhatOrder* bp = new BruhatOrder(hd); // pointer stored immediately: safe
+  BruhatOrder* bp = new BruhatOrder(std::move(hd)); // pointer stored immediately: safe
 
   // commit
   assert(d_bruhat==NULL); // so no |delete| is needed
@@ -814,6 +987,176 @@ void KGB::fillBruhat()
 
 
 
+/*
+
+     The KGB class, cache files
+
+  When a cache directory is set, each |KGB| set is written to a file there
+  after construction, and constructing it again in a later session reads
+  that file instead. The file name is derived from the |cache_key|, which is
+  stored in full in the header of the file. All numbers are written with
+  |basic_io::write_bytes|. After the header come the size and the number of
+  involutions, then each involution as a reduced word (its length in two
+  bytes, followed by the letters, one byte each), the table |first_of_tau|,
+  for each element its status (two bits per generator), descent set,
+  Hermitian dual and torus part (its size in one byte, then its bits), and
+  finally for each element and generator its cross image, Cayley image and
+  inverse Cayley images.
+
+  Numbers of involutions are specific to a session, so involutions are
+  written as Weyl words, and looked up on reading. The ordering of elements
+  depends on the ordering of the involutions, which is (with ties broken by
+  their number) by length; if the involutions read are not so ordered in the
+  current session, freshly generating the set would number it differently,
+  and the file is not used (it will be overwritten).
+
+*/
+
+// the key identifying a cache file: root datum, inner class, real form...
+std::vector<int> KGB::cache_key(const BitMap& Cartan_classes, bool dual_twist)
+  const
+{
+  std::vector<int> key(1,KGB_cache_format);
+  const std::vector<int> rd_key =
+    root_datum_key(rootDatum(),ic.distinguished());
+  key.insert(key.end(),rd_key.begin(),rd_key.end());
+
+  // ...base point of the real form, and Cartan classes to cover
+  key.push_back(G.realForm());
+  key.push_back(G.base_grading().to_ulong());
+  key.push_back(G.x0_torus_part().size());
+  key.push_back(G.x0_torus_part().data().to_ulong());
+  key.push_back(Cartan_classes.size());
+  for (BitMap::iterator it=Cartan_classes.begin(); it(); ++it)
+    key.push_back(*it);
+  key.push_back(dual_twist ? 1 : 0);
+  return key;
+}
+
+bool KGB::read_cache
+  (const std::vector<int>& key, const BitMap& Cartan_classes)
+{
+  if (KGB_cache_directory.empty())
+    return false;
+  std::ifstream in(cache_file_name("kgb",key).c_str(),std::ios_base::binary);
+  if (not in.is_open() or not cache_header_matches(in,key))
+    return false;
+
+  using basic_io::read_bytes;
+  const Cartan_orbits& i_tab = ic.involution_table();
+  const size_t n = read_bytes<4>(in);
+  const inv_index n_inv = read_bytes<4>(in);
+  if (not in.good() or n_inv!=ic.numInvolutions(Cartan_classes))
+    return false;
+
+  std::vector<InvolutionNbr> invs; invs.reserve(n_inv);
+  for (inv_index i=0; i<n_inv and in.good(); ++i)
+  {
+    WeylWord ww; ww.resize(read_bytes<2>(in));
+    for (size_t j=0; j<ww.size(); ++j)
+      if ((ww[j] = read_bytes<1>(in))>=weylGroup().rank())
+	return false; // not a generator; file is corrupt
+    const TwistedInvolution tw(weylGroup().element(ww));
+    if (i_tab.unseen(tw))
+      return false; // involution not (yet) generated in this session
+    const InvolutionNbr inv = i_tab.nr(tw);
+    if (i>0 and not i_tab.less()(invs.back(),inv))
+      return false; // ordering differs from that of freshly generated set
+    invs.push_back(inv);
+  }
+
+  std::vector<KGBElt> first(n_inv+1);
+  for (inv_index i=0; i<=n_inv; ++i)
+    first[i] = read_bytes<4>(in);
+
+  std::vector<EltInfo> new_info(n);
+  std::vector<TorusPart> torus_parts; torus_parts.reserve(n);
+  for (KGBElt x=0; x<n and in.good(); ++x)
+  {
+    EltInfo& inf = new_info[x];
+    unsigned long long status = read_bytes<8>(in);
+    for (weyl::Generator s=0; s<rank(); ++s,status>>=2)
+      inf.status.set(s,gradings::Status::Value(status&3));
+    inf.desc = DescentSet(read_bytes<4>(in));
+    inf.dual = read_bytes<4>(in);
+    const unsigned int tp_size = read_bytes<1>(in);
+    torus_parts.push_back
+      (TorusPart(BitSet<constants::RANK_MAX>(read_bytes<4>(in)),tp_size));
+  }
+
+  std::vector<std::vector<KGBfields> > new_data
+    (rank(),std::vector<KGBfields>(n));
+  for (KGBElt x=0; x<n and in.good(); ++x)
+    for (weyl::Generator s=0; s<rank(); ++s)
+    {
+      KGBfields& f = new_data[s][x];
+      f.cross_image = read_bytes<4>(in);
+      f.Cayley_image = read_bytes<4>(in);
+      f.inverse_Cayley_image.first = read_bytes<4>(in);
+      f.inverse_Cayley_image.second = read_bytes<4>(in);
+    }
+
+  if (not in.good()) // file was truncated; ignore it
+    return false;
+
+  // now install everything
+  data.swap(new_data);
+  info.swap(new_info);
+  inv_nrs.swap(invs);
+  inv_loc.assign(ic.numInvolutions(),-1);
+  for (inv_index i=0; i<inv_nrs.size(); ++i)
+    inv_loc[inv_nrs[i]] = i;
+  first_of_tau.swap(first);
+  Cartan.clear(); Cartan.reserve(inv_nrs.size());
+  for (auto it=inv_nrs.begin(); it!=inv_nrs.end(); ++it)
+    Cartan.push_back(i_tab.Cartan_class(*it));
+  left_torus_part.swap(torus_parts);
+  return true;
+} // |KGB::read_cache|
+
+void KGB::write_cache(const std::vector<int>& key) const
+{
+  write_cache_file("kgb",key,[this](std::ostream& out)
+  {
+    using basic_io::write_bytes;
+    write_bytes<4>(size(),out);
+    write_bytes<4>(nr_involutions(),out);
+    for (inv_index i=0; i<nr_involutions(); ++i)
+    {
+      const WeylWord ww = weylGroup().word(nth_involution(i).w());
+      write_bytes<2>(ww.size(),out);
+      for (size_t j=0; j<ww.size(); ++j)
+	write_bytes<1>(ww[j],out);
+    }
+    for (inv_index i=0; i<=nr_involutions(); ++i)
+      write_bytes<4>(first_of_tau[i],out);
+
+    for (KGBElt x=0; x<size(); ++x)
+    {
+      unsigned long long status=0;
+      for (weyl::Generator s=rank(); s-->0; )
+	status = status<<2 | info[x].status[s];
+      write_bytes<8>(status,out);
+      write_bytes<4>(info[x].desc.to_ulong(),out);
+      write_bytes<4>(info[x].dual,out);
+      write_bytes<1>(left_torus_part[x].size(),out);
+      write_bytes<4>(left_torus_part[x].data().to_ulong(),out);
+    }
+
+    for (KGBElt x=0; x<size(); ++x)
+      for (weyl::Generator s=0; s<rank(); ++s)
+      {
+	const KGBfields& f = data[s][x];
+	write_bytes<4>(f.cross_image,out);
+	write_bytes<4>(f.Cayley_image,out);
+	write_bytes<4>(f.inverse_Cayley_image.first,out);
+	write_bytes<4>(f.inverse_Cayley_image.second,out);
+      }
+  });
+} // |KGB::write_cache|
+
+
+
 /*****************************************************************************
 
             Chapter II -- The auxiliary classes, methods
@@ -868,6 +1211,62 @@ gradings::Status::Value status(const KGB_base& kgb, KGBElt x, RootNbr alpha)
   return kgb.status(s,x);
 }
 
+const std::string& cache_directory() { return KGB_cache_directory; }
+void set_cache_directory(const std::string& dir) { KGB_cache_directory=dir; }
+
+// the file name is a (FNV-1a) hash of |key|, which the header holds in full
+std::string cache_file_name(const char* kind, const std::vector<int>& key)
+{ return cache_file_name(kind,key,KGB_cache_directory); }
+
+std::string cache_file_name
+  (const char* kind, const std::vector<int>& key, const std::string& dir)
+{
+  unsigned long long h=14695981039346656037ull;
+  for (unsigned int i=0; i<key.size(); ++i)
+    h = (h^static_cast<unsigned int>(key[i]))*1099511628211ull;
+  std::ostringstream name;
+  name << dir << '/' << kind << '-'
+       << std::hex << std::setw(16) << std::setfill('0') << h << ".bin";
+  return name.str();
+}
+
+void write_cache_header(std::ostream& out, const std::vector<int>& key)
+{
+  basic_io::put_int(cache_magic,out);
+  basic_io::put_int(key.size(),out);
+  for (unsigned int i=0; i<key.size(); ++i)
+    basic_io::put_int(key[i],out);
+}
+
+bool cache_header_matches(std::istream& in, const std::vector<int>& key)
+{
+  using basic_io::read_bytes;
+  bool match = read_bytes<4>(in)==cache_magic
+    and read_bytes<4>(in)==key.size();
+  for (unsigned int i=0; match and i<key.size(); ++i)
+    match = static_cast<int>(read_bytes<4>(in))==key[i];
+  return match and in.good();
+}
+
+std::vector<int> root_datum_key
+  (const RootDatum& rd, const WeightInvolution& delta)
+{
+  std::vector<int> key;
+  key.push_back(rd.rank());
+  key.push_back(rd.semisimpleRank());
+  for (weyl::Generator s=0; s<rd.semisimpleRank(); ++s)
+  {
+    const Weight& alpha = rd.simpleRoot(s);
+    key.insert(key.end(),alpha.begin(),alpha.end());
+    const Coweight& alpha_v = rd.simpleCoroot(s);
+    key.insert(key.end(),alpha_v.begin(),alpha_v.end());
+  }
+  for (unsigned int i=0; i<delta.numRows(); ++i)
+    for (unsigned int j=0; j<delta.numColumns(); ++j)
+      key.push_back(delta(i,j));
+  return key;
+}
+
 
 /*****************************************************************************
 
@@ -881,18 +1280,24 @@ namespace {
   \brief Puts in |Hasse| the Hasse diagram of the Bruhat ordering on |kgb|.
 
   Explanation: this is the closure ordering of orbits. We use the algorithm
-  from Richardson and Springer.
+  from Richardson and Springer. Since the row for |x| only uses a row for an
+  element of length one less, all elements of one length are handled in
+  parallel, each by a call of |Hasse_filler|.
 */
-void makeHasse(std::vector<set::EltList>& Hasse, const KGB_base& kgb)
+struct Hasse_filler
 {
-  Hasse.resize(kgb.size());
+  const KGB_base& kgb;
+  std::vector<set::EltList>& Hasse;
+
+  Hasse_filler(const KGB_base& kgb, std::vector<set::EltList>& Hasse)
+  : kgb(kgb), Hasse(Hasse) {}
 
-  for (KGBElt x = 0; x < kgb.size(); ++x)
+  void operator() (KGBElt x)
   {
-    std::set<KGBElt> h_x;
+    set::EltList& h_x = Hasse[x];
     const DescentSet& d = kgb.descent(x);
     if (d.none()) // element is minimal in Bruhat order
-      continue;
+      return;
 
     size_t s = d.firstBit();
     KGBElt sx;
@@ -904,9 +1309,10 @@ void makeHasse(std::vector<set::EltList>& Hasse, const KGB_base& kgb)
       KGBEltPair sxp = kgb.inverseCayley(s,x);
       sx = sxp.first; // and will be inserted below
       if (sxp.second != UndefKGB) // |s| is real type I for |x|
-	h_x.insert(sxp.second);
+	h_x.push_back(sxp.second);
     }
-    h_x.insert(sx);
+    assert(kgb.length(sx)<kgb.length(x)); // so |Hasse[sx]| is already known
+    h_x.push_back(sx);
 
     for (set::EltList::const_iterator
 	   it=Hasse[sx].begin(); it!= Hasse[sx].end(); ++it)
@@ -915,19 +1321,34 @@ void makeHasse(std::vector<set::EltList>& Hasse, const KGB_base& kgb)
       switch (kgb.status(s,z))
       {
       case gradings::Status::ImaginaryNoncompact:
-	h_x.insert(kgb.cayley(s,z));
+	h_x.push_back(kgb.cayley(s,z));
 	break;
       case gradings::Status::Complex:
 	if (not kgb.isDescent(s,z))
-	  h_x.insert(kgb.cross(s,z)); // complex ascent
+	  h_x.push_back(kgb.cross(s,z)); // complex ascent
 	break;
       default: break;
       }
     }
 
-    Hasse[x].assign(h_x.begin(),h_x.end());
-  } // for |x|
+    std::sort(h_x.begin(),h_x.end()); // make the list sorted and unique
+    h_x.erase(std::unique(h_x.begin(),h_x.end()),h_x.end());
+  }
+}; // |struct Hasse_filler|
 
+void makeHasse(std::vector<set::EltList>& Hasse, const KGB_base& kgb)
+{
+  Hasse.assign(kgb.size(),set::EltList());
+  Hasse_filler filler(kgb,Hasse);
+
+  for (KGBElt x = 0; x < kgb.size(); ) // elements are sorted by length
+  {
+    KGBElt level_end = x;
+    while (level_end<kgb.size() and kgb.length(level_end)==kgb.length(x))
+      ++level_end;
+    parallel::for_each_index(x,level_end,filler);
+    x = level_end;
+  }
 }
 
 } // |namespace|
@@ -26,7 +26,11 @@ representing orbits of K on G/B.
 #include "y_values.h"   // containment |TorusElement|
 
 #include <algorithm>
+#include <cstdio>   // |std::rename| in |write_cache_file|
+#include <fstream>
 #include <iostream> // for virtual print method
+#include <string>
+#include <vector>
 
 namespace atlas {
 
@@ -186,6 +190,9 @@ class KGB_base
   KGBEltPair tauPacket(const TwistedInvolution&) const;
   size_t packet_size(const TwistedInvolution&) const;
 
+  // a number summarising all tables, used to recognise a KGB set in caches
+  unsigned long long signature() const;
+
 // virtual methods
   virtual CartanNbr Cartan_class(KGBElt x) const; // default, uses |G| tables
   // print derived-class specific per-element information
@@ -262,6 +269,9 @@ class global_KGB : public KGB_base
   virtual std::ostream& print(std::ostream& strm, KGBElt x) const;
 
  private:
+  struct Link_images; // images of one element for one generator, unnumbered
+  struct Link_finder; // computes |Link_images| for |generate|, in parallel
+
   void generate_involutions(size_t n);
   void generate(size_t predicted_size, bool dual_twist);
 
@@ -362,6 +372,16 @@ and in addition the Hasse diagram (set of all covering relations).
 
 // private methods
 private:
+  struct Link_images; // images of one element for one generator, unnumbered
+  struct Link_finder; // computes |Link_images| for the constructor, in parallel
+
+  // identification of a cache file for the KGB set being constructed
+  std::vector<int> cache_key(const BitMap& Cartan_classes, bool dual_twist)
+    const;
+  bool read_cache // whether tables were loaded
+    (const std::vector<int>& key, const BitMap& Cartan_classes);
+  void write_cache(const std::vector<int>& key) const;
+
   bool is_dual_twist_stable(const RealReductiveGroup& GR, TorusPart& shift)
     const; // auxiliary to see if this dual KGB can be twist-stable
 
@@ -379,6 +399,52 @@ KGBElt any_Cayley (const KGB_base& kgb, KGBElt x, RootNbr alpha);
 
 gradings::Status::Value status(const KGB_base& kgb, KGBElt x, RootNbr alpha);
 
+// directory where involution tables, KGB sets and blocks are cached, if set
+const std::string& cache_directory(); // empty (the default) for none
+void set_cache_directory(const std::string& dir);
+
+// name of the cache file for data of sort |kind| identified by |key|
+std::string cache_file_name(const char* kind, const std::vector<int>& key);
+// same, in another directory (as used by the |Rep_table| cache)
+std::string cache_file_name
+  (const char* kind, const std::vector<int>& key, const std::string& dir);
+// header of cache files, which holds the full |key|
+void write_cache_header(std::ostream& out, const std::vector<int>& key);
+bool cache_header_matches(std::istream& in, const std::vector<int>& key);
+
+// the part of a cache |key| identifying root datum and distinguished involution
+std::vector<int> root_datum_key
+  (const RootDatum& rd, const WeightInvolution& delta);
+
+/*
+  Write the cache file of sort |kind| identified by |key|, if a cache directory
+  is set: its header, followed by whatever |writer(out)| writes. The file is
+  written under a temporary name, which is renamed only if all went well, so
+  that a file found under the proper name is always complete.
+*/
+template<typename Writer>
+  void write_cache_file
+    (const char* kind, const std::vector<int>& key, Writer writer)
+{
+  if (cache_directory().empty())
+    return;
+  const std::string name = cache_file_name(kind,key);
+  const std::string temp_name = name+".tmp";
+  bool written;
+  {
+    std::ofstream out(temp_name.c_str(),
+		      std::ios_base::out | std::ios_base::binary);
+    write_cache_header(out,key);
+    writer(out);
+    written = out.good();
+  }
+  if (not written or std::rename(temp_name.c_str(),name.c_str())!=0)
+  {
+    std::cerr << "Could not write cache file " << name << std::endl;
+    std::remove(temp_name.c_str());
+  }
+}
+
 } // |namespace kgb|
 
 } // |namespace atlas|
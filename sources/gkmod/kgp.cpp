@@ -178,7 +178,7 @@ void KGP::fillClosure()
   }
 
   // store the hasse diagram
-  bruhat = new bruhat::BruhatOrder(hasse);
+  bruhat = new bruhat::BruhatOrder(std::move(hasse));
 } // |KGP::fillClosure|
 
 // helper function - removes redundant edges from a closure relation
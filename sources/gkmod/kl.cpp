@@ -41,8 +41,16 @@
 #include <cassert>
 #include <set>  // for |down_set|
 #include <stdexcept>
+#include <algorithm> // for |std::rotate|
+#include <atomic> // numbering of |Row_stream|s
+#include <mutex>
 
-#include "hashtable.h"
+#include <cstdio> // for |std::rename|
+
+#include "basic_io.h" // for binary checkpoint files
+#include "concurrent_hashtable.h"
+#include "parallel.h"
+#include "profile.h"
 #include "kl_error.h"
 #include "wgraph.h"	// for the |wGraph| function
 
@@ -85,6 +93,75 @@ namespace kl {
   /*! \brief Polynomial 1.q^0. */
   const KLPol One(0,KLCoeff(1)); // Polynomial(d,1) gives 1.q^d.
 
+namespace {
+
+  std::string KL_checkpoint_file; // for top-level KL computations, if set
+  unsigned int KL_checkpoint_interval=0; // minimal seconds between writes
+  const unsigned int checkpoint_magic=0x4B4C4350; // "KLCP" in little-endian
+
+/*
+  The function object passed to |parallel::for_each_index| by |wGraph|. Row |y|
+  only writes the edges leaving |y| towards smaller |x|; edges from |x| to |y|
+  are collected in |up[y]| and attached to their source later, sequentially.
+*/
+struct WGraph_row_filler
+{
+  wgraph::WGraph& wg;
+  const KLContext& klc;
+  std::vector<MuRow>& up;
+  WGraph_row_filler
+    (wgraph::WGraph& wg, const KLContext& klc, std::vector<MuRow>& up)
+    : wg(wg), klc(klc), up(up) {}
+  void operator() (size_t y);
+}; // |struct WGraph_row_filler|
+
+void WGraph_row_filler::operator() (size_t y)
+{
+  const RankFlags& d_y = wg.descent(y);
+  const MuRow& mrow = klc.muRow(y);
+  for (size_t j = 0; j < mrow.size(); ++j)
+  {
+    BlockElt x = mrow[j].first;
+    const RankFlags& d_x = wg.descent(x);
+    if (d_x == d_y)
+      continue;
+    MuCoeff mu = mrow[j].second;
+    if (klc.length(y) - klc.length(x) > 1) // add edge from x to y
+    {
+      up[y].push_back(mrow[j]);
+      continue;
+    }
+    // if we get here, the length difference is 1
+    if (not d_y.contains(d_x)) // then add edge from x to y
+      up[y].push_back(mrow[j]);
+    if (not d_x.contains(d_y)) // then add edge from y to x
+    {
+      wg.edgeList(y).push_back(x);
+      wg.coeffList(y).push_back(mu);
+    }
+  }
+} // |WGraph_row_filler::operator()|
+
+/*
+  Evicted rows recently read back by the current thread, most recent first,
+  for |KLContext::evicted_row|. Entries are identified by the number of their
+  |Row_stream| (never reused) and the row number; being per thread, this small
+  cache needs no lock.
+*/
+struct recent_row
+{
+  unsigned long stream; // |Row_stream::id|, or 0 for an unused entry
+  BlockElt y;
+  KLRow row;
+  recent_row() : stream(0), y(0), row() {}
+};
+const unsigned int recent_row_limit=8; // rows kept per thread
+thread_local std::vector<recent_row> recent_rows;
+
+std::atomic<unsigned long> stream_count(0); // for numbering |Row_stream|s
+
+} // |namespace|
+
 // we wrap |KLPol| into a class |KLPolEntry| that can be used in a |HashTable|
 
 /* This associates the type |KLStore| as underlying storage type to |KLPol|,
@@ -97,6 +174,7 @@ public:
   // constructors
   KLPolEntry() : KLPol() {} // default constructor builds zero polynomial
   KLPolEntry(const KLPol& p) : KLPol(p) {} // lift polynomial to this class
+  KLPolEntry(KLPolRef p) : KLPol(p) {} // copy polynomial from storage
 
   // members required for an Entry parameter to the HashTable template
   typedef KLStore Pooltype;		   // associated storage type
@@ -107,6 +185,71 @@ public:
 
 }; // |class KLPolEntry|
 
+/*
+  The hash table used for interning polynomials during the computation. Rows
+  of the same length are computed independently, possibly by several threads
+  at once, which then share this table. It is a |ConcurrentHashTable|, so
+  threads only wait for each other when interning polynomials that fall into
+  the same shard, and since |KLStore| never moves polynomials once stored,
+  threads can read polynomials already present in |d_store| without locking.
+*/
+class KLContext::KLHash
+{
+  KLStore& store;
+  hashtable::ConcurrentHashTable<KLPolEntry,KLIndex> table;
+
+ public:
+  KLHash(KLStore& store) : store(store), table(store) {}
+
+  KLIndex match(const KLPol& p) { return table.match(p); }
+
+  KLPolRef operator[] (KLIndex i) const { return store[i]; }
+  size_t capacity() const { return table.capacity(); }
+
+  // renumber new polynomials by first use in |rows|, moving them in |store|
+  void renumber_by_use(KLIndex first,
+		       std::vector<KLRow>::iterator begin,
+		       std::vector<KLRow>::iterator end)
+  { table.renumber_by_use(first,begin,end); }
+}; // |class KLContext::KLHash|
+
+/*
+  The information needed when rows are passed to a |Row_sink| as they are
+  completed. Rows that were evicted but are needed again (for |klPol|) are
+  obtained from the sink into the small per-thread cache |recent_rows|; only
+  when a row is not found there is the lock taken, as the sink can serve only
+  one thread at a time.
+*/
+struct KLContext::Row_stream
+{
+  const unsigned long id; // identifies our rows in |recent_rows|
+  Row_sink& sink;
+  size_t budget; // number of bytes of rows to keep in memory
+  BlockElt sent; // rows |y<sent| have been passed to |sink|
+  size_t resident; // bytes used by rows in |d_kl| that have been sent
+
+  std::mutex lock; // serialises access to |sink| and to |reread_count|
+  unsigned long reread_count; // number of rows read back, for statistics
+
+  Row_stream(Row_sink& sink, size_t budget)
+  : id(++stream_count), sink(sink), budget(budget), sent(0), resident(0)
+  , lock(), reread_count(0) {}
+  ~Row_stream() // release rows this thread read back; worker threads are gone
+  { for (auto it=recent_rows.begin(); it!=recent_rows.end(); ++it)
+      if (it->stream==id)
+	*it = recent_row();
+  }
+}; // |struct KLContext::Row_stream|
+
+// The function object passed to |parallel::for_each_index| by |fill_level|
+struct KLContext::Row_filler
+{
+  KLContext& klc;
+  KLHash& hash;
+  Row_filler(KLContext& klc, KLHash& hash) : klc(klc), hash(hash) {}
+  void operator() (size_t y) { klc.fillKLRow(y,hash); }
+}; // |struct KLContext::Row_filler|
+
 
 /*****************************************************************************
 
@@ -152,17 +295,39 @@ bool KLPolEntry::operator!=(KLPolEntry::Pooltype::const_reference e) const
 KLContext::KLContext(const Block_base& b)
   : klsupport::KLSupport(b) // construct unfilled support object from block
   , fill_limit(0)
+  , checkpoint_name()
+  , checkpoint_interval(0)
   , d_kl()
   , d_mu()
-  , d_store(2)
+  , d_store()
+  , d_evicted(0)
+  , d_stream()
 {
   // make sure the support (base class) is filled
   klsupport::KLSupport::fill();
 
-  d_store[d_zero]=Zero; // ensure these polynomials are present
-  d_store[d_one]=One;   // at expected indices, even if maybe absent in |d_kl|
+  d_store.push_back(Zero); // ensure these polynomials are present
+  d_store.push_back(One);  // at expected indices, even if maybe absent in |d_kl|
+}
+
+KLContext::KLContext(const Block_base& b, std::istream& checkpoint)
+  : klsupport::KLSupport(b)
+  , fill_limit(0)
+  , checkpoint_name()
+  , checkpoint_interval(0)
+  , d_kl()
+  , d_mu()
+  , d_store()
+  , d_evicted(0)
+  , d_stream()
+{
+  klsupport::KLSupport::fill();
+  if (not read_checkpoint(checkpoint))
+    throw std::runtime_error("KL checkpoint does not match the block");
 }
 
+KLContext::~KLContext() {} // here |Row_stream| is complete, for |d_stream|
+
 /******** copy, assignment and swap ******************************************/
 
 
@@ -184,7 +349,7 @@ KLPolRef KLContext::klPol(BlockElt x, BlockElt y) const
 {
   if (x==UndefBlock) // partial blocks can cause this in many ways
     return d_store[d_zero];
-  const KLRow& klr = d_kl[y];
+  const KLRow& klr = klRow(y);
   unsigned int inx=prim_index(x,descentSet(y));
 
   if (inx>=klr.size()) // l(x)>=l(y), includes case x==~0: no primitivization
@@ -197,7 +362,7 @@ KLIndex KLContext::KL_pol_index(BlockElt x, BlockElt y) const
 {
   if (x==UndefBlock) // partial blocks can cause this in many ways
     return d_zero;
-  const KLRow& klr = d_kl[y];
+  const KLRow& klr = klRow(y);
   unsigned int inx=prim_index(x,descentSet(y));
   // if |inx>=klr.size()| then |l(primitive(x))>=l(y)|, maybe |primitive(x)==~0|
   return inx<klr.size() ? klr[inx] : inx==self_index(y) ? d_one : d_zero;
@@ -262,10 +427,20 @@ void KLContext::fill(BlockElt y, bool verbose)
   if (y<fill_limit)
     return; // tables present already sufficiently large for |y|
 
+  if (fill_limit==0 and not checkpoint_name.empty())
+  { // try to resume from a previous computation for this block
+    std::ifstream in(checkpoint_name.c_str(),std::ios_base::binary);
+    if (in.is_open() and read_checkpoint(in) and y<fill_limit)
+      return;
+  }
+
 #ifndef VERBOSE
   verbose=false; // if compiled for silence, force this variable
 #endif
 
+  profile::phase timer("KL polynomials");
+  const BlockElt old_limit = fill_limit;
+  const KLIndex old_polys = d_store.size();
   try
   {
     d_kl.resize(y+1);
@@ -280,10 +455,14 @@ void KLContext::fill(BlockElt y, bool verbose)
       silent_fill(y);
 
     fill_limit = y+1; // commit extension of tables
+    timer.count("rows",fill_limit-old_limit);
+    timer.count("polynomials",d_store.size()-old_polys);
   }
   catch (std::bad_alloc)
   { // roll back, and transform failed allocation into MemoryOverflow
     std::cerr << "\n memory full, KL computation abondoned." << std::endl;
+    if (d_stream!=nullptr and d_stream->sent>fill_limit)
+      fill_limit=d_stream->sent; // rows passed to the sink are complete
     d_kl.resize(fill_limit);
     d_mu.resize(fill_limit); // truncate to previous contents
     throw error::MemoryOverflow();
@@ -316,6 +495,18 @@ BitMap KLContext::primMap (BlockElt y) const
   return result;
 }
 
+// rows still in memory, $\mu$ lists and polynomial store; ignores |KLSupport|
+size_t KLContext::memory_use() const
+{
+  size_t result = d_kl.capacity()*sizeof(KLRow)
+    + d_mu.capacity()*sizeof(MuRow) + d_store.memory_use();
+  for (BlockElt y=d_evicted; y<d_kl.size(); ++y)
+    result += d_kl[y].capacity()*sizeof(KLIndex);
+  for (BlockElt y=0; y<d_mu.size(); ++y)
+    result += d_mu[y].capacity()*sizeof(MuRow::value_type);
+  return result;
+}
+
 
 /*****************************************************************************
 
@@ -895,7 +1086,7 @@ void KLContext::newRecursionRow
 
 	  //subtract (q-1)P_{xprime,y} from terms of expression (3.4)
 	  BlockElt xprime = cayley(s,x).first;
-	  const KLPol& P_xprime_y =  klPol(xprime,y);
+	  KLPolRef P_xprime_y =  klPol(xprime,y);
 	  pol.safeAdd(P_xprime_y);
 	  pol.safeSubtract(P_xprime_y,1);
 
@@ -1000,14 +1191,48 @@ KLPol KLContext::muNewFormula
 } // |KLContext::muNewFormula|
 
 
+/*
+  Fill the rows |y| in $[y_begin,y_end)$, all of which have the same length.
+
+  These rows only depend on rows for shorter elements, so they can be computed
+  in any order, and in particular by several threads at once. This does make
+  the order in which new polynomials are interned unpredictable, so we
+  afterwards renumber them to the order in which a sequential computation
+  would have found them: then the results do not depend on the thread count.
+
+  A sequential fill calls |match| for entries of a row in decreasing order,
+  both in |complete_primitives| and in |newRecursionRow|, so traversing rows
+  in that manner, and giving new numbers to polynomials at their first
+  occurrence, reproduces the numbering it would have produced. Every new
+  polynomial occurs somewhere in these rows, as it was interned for one.
+*/
+void KLContext::fill_level(BlockElt y_begin, BlockElt y_end, KLHash& hash)
+{
+  const KLIndex first_new = d_store.size();
+  Row_filler filler(*this,hash);
+  parallel::for_each_index(y_begin,y_end,filler);
+  if (parallel::thread_count()>1)
+    hash.renumber_by_use(first_new,d_kl.begin()+y_begin,d_kl.begin()+y_end);
+}
+
 void KLContext::silent_fill(BlockElt last_y)
 {
   try
   {
     KLHash hash(d_store); // (re-)construct a hastable for polynomial storage
-    // fill the lists
-    for (BlockElt y=fill_limit; y<=last_y; ++y)
-      fillKLRow(y,hash);
+    std::time_t last_checkpoint = std::time(nullptr);
+    // fill the lists, one length at a time
+    for (BlockElt y=fill_limit; y<=last_y; )
+    {
+      BlockElt y_limit = lengthLess(length(y)+1);
+      if (y_limit>last_y)
+	y_limit = last_y+1;
+      fill_level(y,y_limit,hash);
+      y = y_limit;
+      if (d_stream!=nullptr)
+	pass_rows(y_limit);
+      checkpoint(y_limit,last_checkpoint);
+    }
     // after all rows are done the hash table is freed, only the store remains
   }
   catch (kl_error::KLError& e)
@@ -1037,30 +1262,33 @@ void KLContext::verbose_fill(BlockElt last_y)
     std::time_t time;
 
     struct rusage usage; //holds Resource USAGE report
-    size_t storesize = 0; // previous size of d_store
-    size_t polsize = 0; // running total of sum of (polynomial degrees+1)
-
     size_t kl_size = 0;
+    std::time_t last_checkpoint = time0;
 
     for (size_t l=minLength; l<=maxLength; ++l) // by length for progress report
     {
       BlockElt y_start = l==minLength ? fill_limit : lengthLess(l);
       BlockElt y_limit = l<maxLength ? lengthLess(l+1) : last_y+1;
-      for (BlockElt y=y_start; y<y_limit; ++y)
+      if (parallel::thread_count()>1)
       {
-	std::cerr << y << "\r";
+	std::cerr << y_start << "\r";
+	fill_level(y_start,y_limit,hash);
+      }
+      else // report progress for each row
+	for (BlockElt y=y_start; y<y_limit; ++y)
+	{
+	  std::cerr << y << "\r";
+	  fillKLRow(y,hash);
+	}
 
-	fillKLRow(y,hash);
+      for (BlockElt y=y_start; y<y_limit; ++y)
 	kl_size += d_kl[y].size();
-      }
+      if (d_stream!=nullptr)
+	pass_rows(y_limit);
 
       // now length |l| is completed
       size_t p_capacity // currently used memory for polynomials storage
-	= hash.capacity()*sizeof(KLIndex) + d_store.capacity()*sizeof(KLPol);
-      for (size_t i=storesize; i<d_store.size(); ++i)
-	polsize+= (d_store[i].degree()+1)*sizeof(KLCoeff);
-      storesize = d_store.size(); // avoid recounting polynomials!
-      p_capacity += polsize;
+	= hash.capacity()*sizeof(KLIndex) + d_store.memory_use();
 
       std::cerr // << "t="    << std::setw(5) << deltaTime << "s.
 	<< "l=" << std::setw(3) << l // completed length
@@ -1084,6 +1312,8 @@ void KLContext::verbose_fill(BlockElt last_y)
 		<< std::setw(6) << kl_size*sizeof(KLIndex)/1048576
 		<< "MB \n";
 
+      checkpoint(y_limit,last_checkpoint);
+
     } // for (l=min_length+1; l<=max_Length; ++l)
 
     std::time(&time);
@@ -1092,6 +1322,10 @@ void KLContext::verbose_fill(BlockElt last_y)
     std::cerr << "Total elapsed time = " << deltaTime << "s." << std::endl;
     std::cerr << d_store.size() << " polynomials, "
 	      << kl_size << " matrix entries."<< std::endl;
+    if (d_stream!=nullptr)
+      std::cerr << d_evicted << " rows evicted, "
+		<< d_stream->reread_count << " times a row was read back."
+		<< std::endl;
 
     std::cerr << std::endl;
 
@@ -1108,6 +1342,279 @@ void KLContext::verbose_fill(BlockElt last_y)
 
 
 
+/*****************************************************************************
+
+        Chapter III -- Checkpoints
+
+  A computation of KL polynomials that takes hours can save its state in a
+  checkpoint file at the end of each length level, so that after interruption
+  another process can resume it from there. The binary file format, written
+  using |basic_io::put_int| (4 bytes little-endian per number) is as follows.
+  A header has a magic number, a signature of the block (see |signature|),
+  the block size, and the number |limit| of rows saved. Then follow all the
+  polynomials of |d_store| in order, each as its number of coefficients
+  followed by the coefficients; then for each row |y<limit| the size of
+  |d_kl[y]| followed by its entries, and finally for each |y<limit| the
+  number of pairs in |d_mu[y]| followed by those pairs.
+
+ *****************************************************************************/
+
+/*
+  A (FNV-1a) hash of the lengths, descent statuses, cross actions and Cayley
+  transforms of all elements of the block, which determine the KL polynomials.
+  This is to avoid resuming from a checkpoint for another block by mistake;
+  blocks with the same shape but different links give different signatures.
+*/
+unsigned long long KLContext::signature() const
+{
+  unsigned long long result=14695981039346656037ull;
+  const auto add = [&result](unsigned long long n)
+    { result = (result^n)*1099511628211ull; };
+  const Block_base& b = block();
+  add(size()); add(rank());
+  for (BlockElt y=0; y<size(); ++y)
+  {
+    add(length(y));
+    for (weyl::Generator s=0; s<rank(); ++s)
+    {
+      add(b.descentValue(s,y));
+      add(b.cross(s,y));
+      add(b.cayley(s,y).first);
+      add(b.cayley(s,y).second);
+    }
+  }
+  return result;
+}
+
+void KLContext::write_rows(std::ostream& out, BlockElt limit) const
+{
+  const unsigned long long sig=signature();
+  basic_io::put_int(checkpoint_magic,out);
+  basic_io::put_int(sig&0xFFFFFFFF,out);
+  basic_io::put_int(sig>>16>>16,out);
+  basic_io::put_int(size(),out);
+  basic_io::put_int(limit,out);
+
+  basic_io::put_int(d_store.size(),out);
+  for (KLIndex i=0; i<d_store.size(); ++i)
+  {
+    KLPolRef P=d_store[i];
+    basic_io::put_int(P.size(),out);
+    for (size_t j=0; j<P.size(); ++j)
+      basic_io::put_int(P[j],out);
+  }
+
+  for (BlockElt y=0; y<limit; ++y)
+  {
+    const KLRow& row = klRow(y);
+    basic_io::put_int(row.size(),out);
+    for (size_t i=0; i<row.size(); ++i)
+      basic_io::put_int(row[i],out);
+  }
+
+  for (BlockElt y=0; y<limit; ++y)
+  {
+    basic_io::put_int(d_mu[y].size(),out);
+    for (size_t i=0; i<d_mu[y].size(); ++i)
+    {
+      basic_io::put_int(d_mu[y][i].first,out);
+      basic_io::put_int(d_mu[y][i].second,out);
+    }
+  }
+
+  if (not out.good())
+    throw std::runtime_error("Failure writing KL checkpoint");
+}
+
+/*
+  Read a checkpoint into a |KLContext| for which no rows have been computed,
+  returning |false| without changing anything if it was not written for our
+  block, appears to be truncated, or holds sizes or indices out of range for
+  the block (so that using it would go out of bounds). Otherwise the tables
+  are replaced by those read, and |fill_limit| is set.
+*/
+bool KLContext::read_checkpoint(std::istream& in)
+{
+  using basic_io::read_bytes;
+  assert(fill_limit==0);
+  if (read_bytes<4>(in)!=checkpoint_magic)
+    return false;
+  unsigned long long sig=read_bytes<4>(in);
+  sig += read_bytes<4>(in)<<32;
+  if (sig!=signature() or read_bytes<4>(in)!=size())
+    return false;
+  const BlockElt limit=read_bytes<4>(in);
+  if (limit>size() or not in.good())
+    return false;
+
+  KLStore store;
+  const KLIndex n_pols=read_bytes<4>(in);
+  std::vector<KLCoeff> coef;
+  const size_t max_size = size()==0 ? 1 : length(size()-1)+1; // exceeds degree
+  for (KLIndex i=0; i<n_pols and in.good(); ++i)
+  {
+    const size_t pol_size=read_bytes<4>(in);
+    if (pol_size>max_size)
+      return false;
+    coef.resize(pol_size);
+    for (size_t j=0; j<coef.size(); ++j)
+      coef[j]=read_bytes<4>(in);
+    store.push_back(KLPolRef(coef.data(),coef.size()));
+  }
+
+  std::vector<KLRow> kl(limit);
+  for (BlockElt y=0; y<limit and in.good(); ++y)
+  {
+    const size_t row_size=read_bytes<4>(in);
+    if (row_size>y+1) // a row has at most one entry for each |x<=y|
+      return false;
+    kl[y].resize(row_size);
+    for (size_t i=0; i<kl[y].size(); ++i)
+      if ((kl[y][i]=read_bytes<4>(in))>=n_pols)
+	return false; // not a polynomial of the file
+  }
+
+  std::vector<MuRow> mu(limit);
+  for (BlockElt y=0; y<limit and in.good(); ++y)
+  {
+    const size_t row_size=read_bytes<4>(in);
+    if (row_size>y) // only |x<y| can have $\mu(x,y)\neq0$
+      return false;
+    mu[y].resize(row_size);
+    for (size_t i=0; i<mu[y].size(); ++i)
+    {
+      if ((mu[y][i].first=read_bytes<4>(in))>=y)
+	return false;
+      mu[y][i].second=read_bytes<4>(in);
+    }
+  }
+
+  if (not in.good()) // some |read_bytes| hit end of file; ignore checkpoint
+    return false;
+
+  d_store.swap(store);
+  d_kl.swap(kl);
+  d_mu.swap(mu);
+  fill_limit=limit;
+  return true;
+}
+
+/*
+  Write a checkpoint of the rows below |limit|, provided this was requested
+  for this context by |set_checkpoint| and enough time has passed since
+  |last|, which is then updated. Only top-level computations (Fokko's block
+  mode) request this, with the file set by |kl::set_checkpoint|; the many
+  small blocks filled by |Rep_table|, possibly in several threads at once, do
+  not write checkpoints. The file is written under a temporary name and then
+  renamed, so that interruption while writing leaves the previous checkpoint
+  intact. Failure to write is reported, but does not interrupt the computation.
+*/
+void KLContext::checkpoint(BlockElt limit, std::time_t& last) const
+{
+  if (checkpoint_name.empty() or d_stream!=nullptr)
+    return;
+  std::time_t now = std::time(nullptr);
+  if (difftime(now,last)<checkpoint_interval)
+    return;
+
+  const std::string temp_name = checkpoint_name+".tmp";
+  try
+  {
+    {
+      std::ofstream out(temp_name.c_str(),
+			std::ios_base::out | std::ios_base::binary);
+      write_rows(out,limit);
+    }
+    if (std::rename(temp_name.c_str(),checkpoint_name.c_str())!=0)
+      throw std::runtime_error("Could not rename KL checkpoint file");
+  }
+  catch (std::runtime_error& e)
+  {
+    std::cerr << e.what() << "; continuing without checkpoint." << std::endl;
+  }
+  last = now;
+}
+
+
+/*****************************************************************************
+
+        Chapter IV -- Streaming rows
+
+  For large blocks the matrix |d_kl| is what takes most memory, while for
+  writing it to disk, or for computing the W-graph, only rows that are
+  complete are needed, one at a time. Therefore rows can be passed as they are
+  completed to a |Row_sink|, which typically writes them to a matrix file, and
+  then be evicted from memory. The recursions however need rows |z| with
+  $\mu(z,y')\neq0$ for some |y'| one length below the row being computed,
+  which can be any row of smaller length, so it is not known in advance which
+  rows are no longer needed. We therefore keep as many rows as the memory
+  budget allows, evicting the oldest (shortest) first, and get evicted rows
+  back from the sink in the rare cases where they are needed again.
+
+  This is not combined with checkpoints, which need all rows in memory; the
+  matrix file written by a sink serves for recovering results in any case.
+
+ *****************************************************************************/
+
+void KLContext::stream_rows(Row_sink& sink, size_t budget)
+{
+  assert(d_stream==nullptr); // a sink can be set only once
+  d_stream.reset(new Row_stream(sink,budget));
+  pass_rows(fill_limit); // rows already computed are passed right away
+}
+
+/*
+  Pass rows before |y_end| not yet handled to the sink, and then evict rows in
+  increasing order while memory use is over budget. This is called in between
+  filling levels, so no other threads are accessing rows.
+*/
+void KLContext::pass_rows(BlockElt y_end)
+{
+  Row_stream& s = *d_stream;
+  for (; s.sent<y_end; ++s.sent)
+  {
+    s.sink.put_row(*this,s.sent);
+    s.resident += d_kl[s.sent].capacity()*sizeof(KLIndex);
+  }
+
+  while (s.resident>s.budget and d_evicted<s.sent)
+  {
+    s.resident -= d_kl[d_evicted].capacity()*sizeof(KLIndex);
+    KLRow().swap(d_kl[d_evicted++]); // actually free the memory of the row
+  }
+}
+
+/*
+  The row |y<d_evicted|, which is read back from the sink if necessary. The
+  reference returned is valid until the current thread has read back
+  |recent_row_limit| further rows; callers use one row at a time.
+*/
+const KLRow& KLContext::evicted_row(BlockElt y) const
+{
+  Row_stream& s = *d_stream;
+  for (auto it=recent_rows.begin(); it!=recent_rows.end(); ++it)
+    if (it->stream==s.id and it->y==y)
+    {
+      std::rotate(recent_rows.begin(),it,it+1); // move it to the front
+      return recent_rows.front().row;
+    }
+
+  if (recent_rows.size()<recent_row_limit)
+    recent_rows.emplace_back();
+  std::rotate(recent_rows.begin(),recent_rows.end()-1,recent_rows.end());
+  recent_row& entry = recent_rows.front(); // the least recent entry, reused
+  entry.stream = 0; // until the row is read successfully
+  {
+    std::lock_guard<std::mutex> guard(s.lock);
+    s.sink.get_row(y,entry.row);
+    ++s.reread_count;
+  }
+  entry.stream = s.id;
+  entry.y = y;
+  return entry.row;
+}
+
+
 /*****************************************************************************
 
         Chapter V -- Functions declared in kl.h
@@ -1134,6 +1641,7 @@ void KLContext::verbose_fill(BlockElt last_y)
 */
 void wGraph(wgraph::WGraph& wg, const KLContext& klc)
 {
+  profile::phase timer("W graph");
   wg.reset();
   wg.resize(klc.size());
 
@@ -1141,34 +1649,43 @@ void wGraph(wgraph::WGraph& wg, const KLContext& klc)
   for (BlockElt y = 0; y < klc.size(); ++y)
     wg.descent(y) = klc.descentSet(y);
 
-  // fill in edges and coefficients
-  for (BlockElt y = 0; y < klc.size(); ++y) {
-    const RankFlags& d_y = wg.descent(y);
-    const MuRow& mrow = klc.muRow(y);
-    for (size_t j = 0; j < mrow.size(); ++j) {
-      BlockElt x = mrow[j].first;
-      const RankFlags& d_x = wg.descent(x);
-      if (d_x == d_y)
-	continue;
-      MuCoeff mu = mrow[j].second;
-      if (klc.length(y) - klc.length(x) > 1) { // add edge from x to y
-	wg.edgeList(x).push_back(y);
-	wg.coeffList(x).push_back(mu);
-	continue;
-      }
-      // if we get here, the length difference is 1
-      if (not d_y.contains(d_x)) { // then add edge from x to y
-	wg.edgeList(x).push_back(y);
-	wg.coeffList(x).push_back(mu);
-      }
-      if (not d_x.contains(d_y)) { // then add edge from y to x
-	wg.edgeList(y).push_back(x);
-	wg.coeffList(y).push_back(mu);
-      }
+  /* fill in edges and coefficients; the rows are independent, except that
+     an edge from |x| to |y| is stored at |x|. Such edges are therefore
+     gathered per |y| first, and then appended in order of increasing |y|, so
+     the edge lists come out exactly as a sequential pass would make them */
+  std::vector<MuRow> up(klc.size());
+  WGraph_row_filler filler(wg,klc,up);
+  parallel::for_each_index(0,klc.size(),filler);
+
+  for (BlockElt y = 0; y < klc.size(); ++y)
+  {
+    for (size_t j = 0; j < up[y].size(); ++j)
+    {
+      BlockElt x = up[y][j].first;
+      wg.edgeList(x).push_back(y);
+      wg.coeffList(x).push_back(up[y][j].second);
     }
+    timer.count("edges",up[y].size());
+    MuRow().swap(up[y]); // release memory as we go
   }
 
 } // |wGraph|
 
+const std::string& checkpoint_file() { return KL_checkpoint_file; }
+unsigned int checkpoint_interval() { return KL_checkpoint_interval; }
+
+/*
+  Set the checkpoint file for top-level KL computations: those pass it on to
+  |KLContext::set_checkpoint|, so that |fill| writes its progress to
+  |file_name| at the end of each length level, but at most once per
+  |seconds|, and at the start resumes from that file if it was written for the
+  same block. An empty |file_name| switches this off.
+*/
+void set_checkpoint(const std::string& file_name, unsigned int seconds)
+{
+  KL_checkpoint_file=file_name;
+  KL_checkpoint_interval=seconds;
+}
+
 } // |namespace kl|
 } // |namespace atlas|
@@ -16,11 +16,16 @@
 
 #include <limits>
 #include <set>
+#include <string>
+#include <iosfwd>
+#include <ctime>
+#include <memory> // for |std::unique_ptr|
 
 #include "../Atlas.h"
 
 #include "klsupport.h"	// containment
 #include "polynomials.h"// containment
+#include "poly_store.h" // containment of |KLStore|
 
 namespace atlas {
 
@@ -30,6 +35,11 @@ namespace kl {
 
   void wGraph(wgraph::WGraph&, const KLContext&);
 
+  // checkpoint file for top-level KL computations (see |KLContext::checkpoint|)
+  const std::string& checkpoint_file(); // empty (the default) for none
+  unsigned int checkpoint_interval(); // minimal seconds between writes
+  void set_checkpoint(const std::string& file_name, unsigned int seconds=0);
+
 }
 
 /******** type definitions **************************************************/
@@ -42,6 +52,20 @@ typedef std::vector<std::pair<BlockElt,MuCoeff> > MuRow;
 
 class KLPolEntry; // class definition will given in the implementation file
 
+/*
+  A |Row_sink| receives the rows of a |KLContext| as they are completed, and
+  can later produce them again. Handing one to |KLContext::stream_rows| allows
+  rows to be evicted from memory, which is useful if the KL matrix is larger
+  than memory but will only be written to disk anyway.
+*/
+class Row_sink
+{
+ public:
+  virtual ~Row_sink() {}
+  virtual void put_row(const KLContext& klc, BlockElt y) = 0; // rows in order
+  virtual void get_row(BlockElt y, KLRow& row) = 0; // read back |put| row |y|
+}; // |class Row_sink|
+
 /*
   |KLContext| is a class that Calculates and stores the
   Kazhdan-Lusztig-Vogan polynomials for a block of representations of $G$.
@@ -52,6 +76,9 @@ class KLContext
 
   BlockElt fill_limit; // all "rows" |y| with |y<fill_limit| have been computed
 
+  std::string checkpoint_name; // where |fill| saves progress; empty for none
+  unsigned int checkpoint_interval; // minimal seconds between checkpoints
+
 /*
   |d_kl[y]| is a list of indices into |d_hashtable| of polynomials
   $P_{x_i,y}$ with $x_i$ equal to primitive element number $i$ for
@@ -66,6 +93,11 @@ class KLContext
 
   KLStore d_store; // the distinct actual polynomials
 
+  // when rows are streamed to a |Row_sink|, those |y<d_evicted| are not kept
+  BlockElt d_evicted; // they are absent from |d_kl|, and obtained from sink
+  struct Row_stream; // information used for streaming, defined in kl.cpp
+  std::unique_ptr<Row_stream> d_stream; // null unless |stream_rows| is called
+
   // the constructors will ensure that |d_store| contains 0, 1 at beginning
   enum { d_zero = 0, d_one  = 1}; // indices of polynomials 0,1 in |d_store|
   // using enum rather than |static const int| allows implicit const references
@@ -78,6 +110,9 @@ class KLContext
 
 // constructors and destructors
   KLContext(const Block_base&); // construct initial base object
+  // restart from a checkpoint written for block |b|; throws if it does not fit
+  KLContext(const Block_base& b, std::istream& checkpoint);
+  ~KLContext();
 
 // accessors
   // construct lists of extremal respectively primitive elements for |y|
@@ -92,7 +127,8 @@ class KLContext
   // That polynomial in the form of an index into |polStore()==d_store|
   KLIndex KL_pol_index(BlockElt x, BlockElt y) const;
 
-  const KLRow& klRow(BlockElt y) const { return d_kl[y]; }
+  const KLRow& klRow(BlockElt y) const
+  { return y>=d_evicted ? d_kl[y] : evicted_row(y); }
 
   MuCoeff mu(BlockElt x, BlockElt y) const; // $\mu(x,y)$
 
@@ -105,6 +141,12 @@ class KLContext
   // get bitmap of primitive elements for row |y| with nonzero KL polynomial
   BitMap primMap (BlockElt y) const;
 
+  size_t memory_use() const; // approximate bytes held by rows and polynomials
+
+  // write the computed rows in the form read back by the constructor above
+  void write_checkpoint(std::ostream& out) const
+  { write_rows(out,fill_limit); }
+
 // manipulators
 
   // partial fill, up to and including the "row" of |y|
@@ -113,10 +155,19 @@ class KLContext
   void fill(bool verbose=true)
   { fill(size()-1,verbose); } // simulate forbidden first default argument
 
+  // have |fill| resume from, and save its progress to, the file |file_name|
+  void set_checkpoint(const std::string& file_name, unsigned int seconds=0)
+  { checkpoint_name=file_name; checkpoint_interval=seconds; }
+
+  // from now on pass completed rows to |sink|, evicting rows from memory
+  // (oldest first) while those kept exceed |budget| bytes
+  void stream_rows(Row_sink& sink, size_t budget);
+
 
   // private methods used during construction
  private:
-  typedef HashTable<KLPolEntry,KLIndex> KLHash;
+  class KLHash; // polynomial table that threads can share; defined in kl.cpp
+  struct Row_filler; // function object to fill rows, possibly from threads
 
   //accessors
     weyl::Generator firstDirectRecursion(BlockElt y) const;
@@ -125,6 +176,11 @@ class KLContext
       first_endgame_pair(BlockElt x, BlockElt y) const;
     BlockEltPair inverseCayley(size_t s, BlockElt y) const;
     std::set<BlockElt> down_set(BlockElt y) const;
+    const KLRow& evicted_row(BlockElt y) const; // obtain row from the sink
+
+    unsigned long long signature() const; // to recognise our block on reading
+    void write_rows(std::ostream& out, BlockElt limit) const;
+    void checkpoint(BlockElt limit, std::time_t& last) const; // when due
 
     KLPolRef klPol(BlockElt x, BlockElt y,
 		   KLRow::const_iterator klv,
@@ -134,6 +190,10 @@ class KLContext
     // manipulators
     void silent_fill(BlockElt last_y);
     void verbose_fill(BlockElt last_y);
+    bool read_checkpoint(std::istream& in); // whether it fits, and was read
+    void pass_rows(BlockElt y_end); // stream rows completed, evict as needed
+
+    void fill_level(BlockElt y_begin, BlockElt y_end, KLHash& hash);
 
     void fillKLRow(BlockElt y, KLHash& hash);
     void recursionRow(std::vector<KLPol> & klv,
@@ -11,6 +11,12 @@
 
 #include <map> // used in computing |reducibility_points|
 #include <iostream>
+#include <fstream> // for reading the persistent cache of |Rep_table|
+#include <stdexcept>
+#include <memory> // for |std::unique_ptr| in |plan_deformation|
+#include <set> // keys of blocks in a batch, in |plan_deformation|
+#include <algorithm> // for |std::min|
+#include <unistd.h> // for |truncate|
 #include "error.h"
 
 #include "arithmetic.h"
@@ -28,10 +34,20 @@
 #include "ext_kl.h"
 
 #include "basic_io.h"
+#include "parallel.h"
+#include "profile.h"
 
 namespace atlas {
   namespace repr {
 
+namespace {
+
+  std::string Rep_cache_directory; // where |Rep_table| caches are kept, if set
+  const int cache_format=2; // increase when the key or record format changes
+  size_t Rep_block_budget=size_t(64)<<20; // bytes for each |block_cache|
+
+} // |namespace|
+
 bool StandardRepr::operator== (const StandardRepr& z) const
 { return x_part==z.x_part and y_bits==z.y_bits
   and infinitesimal_char==z.infinitesimal_char;
@@ -223,13 +239,14 @@ unsigned int Rep_context::orientation_number(const StandardRepr& z) const
   const Weight test_wt =
     i_tab.y_lift(i_x,z.y()) +rd.twoRho() -rd.twoRho(real);
 
+  const Ratvec_Numer_t pairings = rd.posCoroot_pairings(numer);
   unsigned count = 0;
 
   for (unsigned i=0; i<rd.numPosRoots(); ++i)
   {
     const RootNbr alpha = rd.numPosRoots()+i;
     const Weight& av = rootDatum().coroot(alpha);
-    const arithmetic::Numer_t num = av.dot(numer);
+    const arithmetic::Numer_t num = pairings[i];
     if (num%denom!=0) // skip integral roots
     { if (real.isMember(alpha))
       {
@@ -241,9 +258,11 @@ unsigned int Rep_context::orientation_number(const StandardRepr& z) const
       else // complex root
       {
 	assert(i_tab.complex_roots(i_x).isMember(alpha));
-	const RootNbr beta = root_inv[alpha];
-	if (i<rd.rt_abs(beta) // consider only first conjugate "pair"
-	    and (num>0)!=(rootDatum().coroot(beta).dot(numer)>0))
+	const RootNbr beta = root_inv[alpha], b = rd.rt_abs(beta);
+	const arithmetic::Numer_t num_beta =
+	  rd.is_posroot(beta) ? pairings[b] : -pairings[b];
+	if (i<b // consider only first conjugate "pair"
+	    and (num>0)!=(num_beta>0))
 	  ++count;
       }
     }
@@ -257,16 +276,21 @@ void Rep_context::W_act(const WeylWord& w,StandardRepr& z) const
   Weight lr = lambda_rho(z);
   KGBElt& x = z.x_part;
   Ratvec_Numer_t& numer = z.infinitesimal_char.numerator();
+  rootdata::simple_pairings<arithmetic::Numer_t> gamma(rd,numer);
+  rootdata::simple_pairings<int> lambda(rd,lr);
 
   for (unsigned i=w.size(); i-->0; )
   {
     weyl::Generator s=w[i];
-    rd.simple_reflect(s,numer);
-    rd.simple_reflect(s,lr);
+    gamma.reflect(s);
     if (kgb().status(s,x)!=gradings::Status::Real) // center at $\rho-\rho_r$
-      lr -= rd.simpleRoot(s); // so unless |s| is real root compensate
+      lambda.subtract(s,lambda[s]+1); // so unless |s| is real root compensate
+    else
+      lambda.reflect(s);
     x = kgb().cross(s,x);
   }
+  gamma.apply(numer);
+  lambda.apply(lr);
   z.y_bits = // reinsert $y$ bits component
     innerClass().involution_table().y_pack(kgb().inv_nr(x),lr);
 }
@@ -307,6 +331,11 @@ WeylWord Rep_context::make_dominant(StandardRepr& z) const
   KGBElt& x = z.x_part;
   Ratvec_Numer_t& numer = z.infinitesimal_char.numerator();
 
+  // only pairings with simple coroots are tracked, |numer| and |lr| are
+  // modified once at the end
+  rootdata::simple_pairings<arithmetic::Numer_t> gamma(rd,numer);
+  rootdata::simple_pairings<int> lambda(rd,lr);
+
   WeylWord result;
   result.reserve(rd.numPosRoots()); // enough to accommodate the WeylWord
 
@@ -314,20 +343,21 @@ WeylWord Rep_context::make_dominant(StandardRepr& z) const
     do
       for (s=0; s<rd.semisimpleRank(); ++s)
       {
-	int v=rd.simpleCoroot(s).dot(numer);
+	arithmetic::Numer_t v=gamma[s];
 	if (v<0 or (v==0 and kgb().isComplexDescent(s,x)))
 	{
 	  result.push_back(s);
-	  rd.simple_reflect(s,numer);
-	  rd.simple_reflect(s,lr);
+	  gamma.reflect(s);
 	  switch (kgb().status(s,x))
 	  {
 	  case gradings::Status::ImaginaryCompact:
 	  case gradings::Status::ImaginaryNoncompact:
 	    throw std::runtime_error("Non standard parameter in make_dominant");
 	  case gradings::Status::Complex:
-	    lr -= rd.simpleRoot(s); // pivot around $\rho-\rho_r$
-	  case gradings::Status::Real: {} // no compensation for real roots
+	    lambda.subtract(s,lambda[s]+1); // pivot around $\rho-\rho_r$
+	    break;
+	  case gradings::Status::Real:
+	    lambda.reflect(s); // no compensation for real roots
 	  }
 	  x = kgb().cross(s,x);
 	  break; // out of the loop |for(s)|
@@ -335,6 +365,8 @@ WeylWord Rep_context::make_dominant(StandardRepr& z) const
       } // |for(s)|
     while (s<rd.semisimpleRank()); // wait until inner loop runs to completion
   }
+  gamma.apply(numer);
+  lambda.apply(lr);
   z.y_bits=innerClass().involution_table().y_pack(kgb().inv_nr(x),lr);
   return result;
 } // |make_dominant|
@@ -399,6 +431,7 @@ RationalList Rep_context::reducibility_points(const StandardRepr& z) const
 
   const RootNbrSet pos_real = i_tab.real_roots(i_x) & rd.posRootSet();
   const Weight two_rho_real = rd.twoRho(pos_real);
+  const Ratvec_Numer_t pairings = rd.posCoroot_pairings(numer);
 
   // we shall associate to certain numbers $num>0$ a strict lower bound $lwb$
   // for which we shall then later form fractions $(d/num)*k$ for $k>lwb$
@@ -409,8 +442,8 @@ RationalList Rep_context::reducibility_points(const StandardRepr& z) const
 
   for (RootNbrSet::iterator it=pos_real.begin(); it(); ++it)
   {
-    arithmetic::Numer_t num =
-      rd.coroot(*it).dot(numer); // now $\<\alpha^v,\nu>=num/d$ (real $\alpha$)
+    arithmetic::Numer_t num = // now $\<\alpha^v,\nu>=num/d$ (real $\alpha$)
+      pairings[rd.rt_abs(*it)];
     if (num!=0)
     {
       long lam_alpha = lam_rho.dot(rd.coroot(*it))+rd.colevel(*it);
@@ -423,8 +456,9 @@ RationalList Rep_context::reducibility_points(const StandardRepr& z) const
   for (RootNbrSet::iterator it=pos_complex.begin(); it(); ++it)
   {
     RootNbr alpha=*it, beta=theta[alpha];
-    arithmetic::Numer_t vala = rd.coroot(alpha).dot(numer);
-    arithmetic::Numer_t valb = rd.coroot(beta).dot(numer);
+    arithmetic::Numer_t vala = pairings[rd.rt_abs(alpha)]; // |alpha| positive
+    arithmetic::Numer_t valb = rd.is_posroot(beta)
+      ? pairings[rd.rt_abs(beta)] : -pairings[rd.rt_abs(beta)];
     arithmetic::Numer_t num = vala - valb; // $2\<\alpha^v,\nu>=num/d$ (complex)
     if (num!=0)
     {
@@ -686,15 +720,27 @@ bool Rep_context::compare::operator()
   return r.y()<s.y(); // uses |SmallBitVector::operator<|, internal comparison
 }
 
+Rep_table::Rep_table(RealReductiveGroup &G)
+  : Rep_context(G), pool(), hash(pool), lengths(), KL_list(), def_formula()
+  , twisted_KLV_list(), twisted_def_formula()
+  , cache_name(), cache_loaded(false), cache_out()
+{
+  if (not Rep_cache_directory.empty())
+    cache_name = kgb::cache_file_name("reps",cache_key(),Rep_cache_directory);
+}
+
+Rep_table::~Rep_table() {} // here the |param_block|s in |block_cache| are known
+
 unsigned int Rep_table::length(StandardRepr z)
 {
+  load_cache();
   make_dominant(z); // should't hurt, and improves chances of finding |z|
   unsigned long hash_index=hash.find(z);
   if (hash_index!=hash.empty)
     return lengths[hash_index];
 
   // otherwise do it the hard way, constructing a block up to |z|
-  param_block block(*this,z); // compute partial block
+  param_block& block = below(z); // compute partial block
   return block.length(block.size()-1);
 }
 
@@ -798,7 +844,7 @@ void Rep_table::add_block(param_block& block, BlockEltList& survivors)
     for (BlockEltList::const_iterator it=z_start; it!=new_survivors.end(); ++it)
     {
       const BlockElt z = *it; // element of |new_survivors| and |x<=z|
-      const kl::KLPol& pol = klc.klPol(x,z); // regular KL polynomial
+      const kl::KLPolRef pol = klc.klPol(x,z); // regular KL polynomial
       Split_integer eval(0);
       for (polynomials::Degree d=pol.size(); d-->0; )
 	eval.times_s()+=static_cast<int>(pol[d]);
@@ -814,11 +860,15 @@ void Rep_table::add_block(param_block& block, BlockEltList& survivors)
       }
     } // |for(it)|
   } // |for(x)|
+
+  for (unsigned long i=old_size; i<hash.size(); ++i)
+    save('K',pool[i],KL_list[i]); // record new columns in persistent cache
 } // |Rep_table::add_block|
 
 // compute and return sum of KL polynomials at $s$ for final parameter |z|
 SR_poly Rep_table::KL_column_at_s(StandardRepr z) // must be nonzero and final
 {
+  load_cache();
   { RootNbr witness;
     assert(not is_zero(z,witness));
     assert(is_final(z,witness));
@@ -828,7 +878,7 @@ SR_poly Rep_table::KL_column_at_s(StandardRepr z) // must be nonzero and final
   unsigned long hash_index=hash.find(z);
   if (hash_index==hash.empty) // previously unknown parameter
   {
-    param_block block(*this,z);
+    param_block& block = below(z);
     BlockEltList survivors;
     add_block(block,survivors);
 
@@ -839,8 +889,78 @@ SR_poly Rep_table::KL_column_at_s(StandardRepr z) // must be nonzero and final
   return KL_list[hash_index];
 } // |Rep_table::KL_column_at_s|
 
+/*
+  Partial blocks below parameters are kept in |block_cache|, so that they can
+  be reused when a block below a translated parameter is needed: one with the
+  same $x$ and $\gamma-\lambda$ after making dominant, and so differing only
+  by an integral weight added to both $\gamma$ and $\lambda$. Such blocks are
+  isomorphic, including their KL polynomials (so the ones already computed
+  remain valid), and |param_block::translate| adapts the one kept to the new
+  infinitesimal character. Since blocks kept include their KL tables, the
+  cache is bounded by memory rather than by number of blocks: when a block is
+  stored, the oldest blocks are evicted while the |memory_use| of all blocks
+  kept exceeds |block_cache_budget()|, though the new block itself is always
+  kept. A block obtained from these methods remains valid until the next call
+  that stores a block in the cache.
+*/
+param_block& Rep_table::below(const StandardRepr& z)
+{
+  param_block* cached = cached_block(z);
+  if (cached!=nullptr)
+  {
+    profile::count("partial param block","reused by translation");
+    return *cached;
+  }
+  return store_block(z,std::unique_ptr<param_block>(new param_block(*this,z)));
+}
+
+Rep_table::block_key Rep_table::key_of(StandardRepr z) const
+{
+  make_dominant(z); // as |param_block| constructor does
+  return block_key(z.x(),(z.gamma()-lambda(z)).normalize());
+}
+
+param_block* Rep_table::cached_block(const StandardRepr& z)
+{
+  auto it = block_cache.find(key_of(z));
+  if (it==block_cache.end())
+    return nullptr;
+  param_block& block = *it->second;
+  StandardRepr top = z;
+  make_dominant(top);
+  block.translate(top.gamma());
+  assert(sr(block,block.size()-1)==top);
+  return &block;
+}
+
+param_block& Rep_table::store_block
+  (const StandardRepr& z, std::unique_ptr<param_block>&& block)
+{
+  const block_key key = key_of(z);
+  std::unique_ptr<param_block>& slot = block_cache[key];
+  if (slot==nullptr) // a new entry
+    block_cache_order.push_back(key);
+  slot = std::move(block);
+  param_block& result = *slot;
+
+  // the memory use of blocks grows as their KL tables are filled; measure now
+  size_t total=0;
+  for (auto it=block_cache.begin(); it!=block_cache.end(); ++it)
+    total += it->second->memory_use();
+  while (total>Rep_block_budget and block_cache_order.front()!=key)
+  { // evict oldest blocks, but never the one just stored
+    auto it = block_cache.find(block_cache_order.front());
+    total -= it->second->memory_use();
+    block_cache.erase(it);
+    block_cache_order.pop_front();
+    profile::count("partial param block","evicted from cache");
+  }
+  return result;
+}
+
 SR_poly Rep_table::deformation_terms (param_block& block,BlockElt entry_elem)
 {
+  load_cache();
   SR_poly result(repr_less());
   if (not block.survives(entry_elem) or block.length(entry_elem)==0)
     return result; // easy cases, null result
@@ -908,6 +1028,145 @@ SR_poly Rep_table::deformation_terms (param_block& block,BlockElt entry_elem)
 } // |deformation_terms|
 
 SR_poly Rep_table::deformation(const StandardRepr& z)
+{
+  profile::phase timer("deformation");
+  load_cache();
+  if (parallel::thread_count()==1)
+    return deformation(z,nullptr); // just do the plain recursion
+
+  deformation_plan plan;
+  plan_deformation(z,plan); // does the hard work for all of the recursion
+  return deformation(z,&plan);
+}
+
+// The function object passed to |parallel::for_each_index| by |plan_deformation|
+struct Rep_table::Block_builder
+{
+  const Rep_table& table;
+  const std::vector<StandardRepr>& tops;
+  const std::vector<bool>& needed; // whether no (translated) block is known
+  std::vector<std::unique_ptr<param_block> >& blocks;
+
+  Block_builder(const Rep_table& table,
+		const std::vector<StandardRepr>& tops,
+		const std::vector<bool>& needed,
+		std::vector<std::unique_ptr<param_block> >& blocks)
+  : table(table), tops(tops), needed(needed), blocks(blocks) {}
+
+  // build partial block below |tops[i]|, with KL polynomials if they are new
+  void operator() (size_t i)
+  {
+    if (not needed[i])
+      return; // the block will be taken from |table.block_cache|
+    blocks[i].reset(new param_block(table,tops[i]));
+    param_block& block = *blocks[i];
+    const BlockElt last = block.size()-1;
+    if (not block.survives(last) or block.length(last)==0)
+      return; // |deformation_terms| will not use this block
+    for (BlockElt x=0; x<=last; ++x)
+      if (block.survives(x) and
+	  table.hash.find(table.sr(block,x))==table.hash.empty)
+      { // then |add_block| needs KL polynomials; compute them now, in parallel
+	block.klc(last,false);
+	return;
+      }
+  }
+}; // |Rep_table::Block_builder|
+
+/*
+  Prepare for computing |deformation(z)| using several threads. The recursion
+  of |deformation| is explored level by level: for the parameters at one level
+  whose deformation is not yet known, the partial blocks at all reducibility
+  points are constructed (unless a translate is found in |block_cache|, or
+  occurs earlier in the batch) and their KL polynomials computed in parallel;
+  these
+  blocks are then added to the tables by |deformation_terms| in the calling
+  thread, which is cheap by now. The terms found are recorded in |plan|, and
+  the parameters occurring in them form the next level. Parameters with the
+  same last reducibility point are explored only once. Afterwards, the call
+  |deformation(z,&plan)| can combine the recorded terms without building any
+  further blocks.
+*/
+void Rep_table::plan_deformation(const StandardRepr& z, deformation_plan& plan)
+{
+  std::vector<StandardRepr> seen_pool; // last reducibility points explored
+  HashTable<StandardRepr,unsigned long> seen(seen_pool);
+
+  // blocks alive at any moment are limited to a few per thread
+  const size_t batch = 4*parallel::thread_count();
+
+  std::vector<StandardRepr> level(1,z);
+  while (not level.empty())
+  {
+    std::vector<StandardRepr> near; // last reducibility points of new ones
+    std::vector<StandardRepr> tops; // parameters at their reducibility points
+    std::vector<unsigned long> owner; // index into |near| for |tops| entries
+    for (auto it=level.begin(); it!=level.end(); ++it)
+    {
+      RationalList rp=reducibility_points(*it);
+      if (rp.size()==0)
+	continue; // no deformation terms
+      const Weight lam_rho = lambda_rho(*it);
+      const RatWeight nu_z = nu(*it);
+      StandardRepr z_near = sr(it->x(),lam_rho,nu_z*rp.back());
+      make_dominant(z_near);
+
+      unsigned long h=hash.find(z_near);
+      if (h!=hash.empty and not def_formula[h].empty())
+	continue; // deformation already known
+      const unsigned long old_size = seen.size();
+      if (seen.match(z_near)<old_size)
+	continue; // deformation already planned
+
+      near.push_back(z_near);
+      for (unsigned i=rp.size(); i-->0; ) // same order as in |deformation|
+      {
+	tops.push_back(sr(it->x(),lam_rho,nu_z*rp[i]));
+	owner.push_back(near.size()-1);
+      }
+    }
+
+    std::vector<SR_poly> terms(near.size(),SR_poly(repr_less()));
+    for (size_t start=0; start<tops.size(); start+=batch)
+    {
+      const size_t stop = std::min(start+batch,tops.size());
+      const std::vector<StandardRepr> batch_tops
+	(tops.begin()+start,tops.begin()+stop);
+      std::vector<bool> needed(batch_tops.size());
+      std::set<block_key> batch_keys;
+      for (size_t i=0; i<batch_tops.size(); ++i)
+      {
+	const block_key key = key_of(batch_tops[i]);
+	needed[i] = block_cache.count(key)==0 and batch_keys.insert(key).second;
+      }
+      std::vector<std::unique_ptr<param_block> > blocks(batch_tops.size());
+      Block_builder builder(*this,batch_tops,needed,blocks);
+      parallel::for_each_index(0,blocks.size(),builder);
+
+      for (size_t i=0; i<blocks.size(); ++i)
+      {
+	param_block& block = needed[i]
+	  ? store_block(batch_tops[i],std::move(blocks[i]))
+	  : below(batch_tops[i]); // rebuilds if evicted meanwhile
+	terms[owner[start+i]] += deformation_terms(block,block.size()-1);
+      }
+    }
+
+    level.clear();
+    for (size_t i=0; i<near.size(); ++i)
+    {
+      for (auto it=terms[i].begin(); it!=terms[i].end(); ++it)
+	level.push_back(it->first);
+      unsigned long h=hash.find(near[i]);
+      if (h!=hash.empty) // should be the case; if not, |deformation| recurs
+	plan.insert(std::make_pair(h,std::move(terms[i])));
+    }
+  } // |while (not level.empty())|
+} // |Rep_table::plan_deformation|
+
+// the deformation recursion, using terms in |plan| when available
+SR_poly Rep_table::deformation(const StandardRepr& z,
+			       const deformation_plan* plan)
 {
   Weight lam_rho = lambda_rho(z);
   RatWeight nu_z =  nu(z);
@@ -921,26 +1180,35 @@ SR_poly Rep_table::deformation(const StandardRepr& z)
   StandardRepr z_near = sr(z.x(),lam_rho,nu_z*rp.back());
   make_dominant(z_near);
 
-  { // look up if closest reducibility point to |z| is already known
-    unsigned long h=hash.find(z_near);
-    if (h!=hash.empty and not def_formula[h].empty())
-      return def_formula[h];
-  }
-
-  for (unsigned i=rp.size(); i-->0; )
-  {
-    Rational r=rp[i];
-    const StandardRepr zi = sr(z.x(),lam_rho,nu_z*r);
-    param_block b(*this,zi);
-    const SR_poly terms = deformation_terms(b,b.size()-1);
+  // look up if closest reducibility point to |z| is already known
+  unsigned long h=hash.find(z_near);
+  if (h!=hash.empty and not def_formula[h].empty())
+    return def_formula[h];
+
+  deformation_plan::const_iterator planned;
+  if (plan!=nullptr and h!=hash.empty and
+      (planned=plan->find(h))!=plan->end())
+  { // all terms were found by |plan_deformation|, just recur on them
+    const SR_poly& terms = planned->second;
     for (SR_poly::const_iterator it=terms.begin(); it!=terms.end(); ++it)
-      result.add_multiple(deformation(it->first),it->second); // recursion
+      result.add_multiple(deformation(it->first,plan),it->second);
   }
+  else
+    for (unsigned i=rp.size(); i-->0; )
+    {
+      Rational r=rp[i];
+      const StandardRepr zi = sr(z.x(),lam_rho,nu_z*r);
+      param_block& b = below(zi);
+      const SR_poly terms = deformation_terms(b,b.size()-1);
+      for (SR_poly::const_iterator it=terms.begin(); it!=terms.end(); ++it)
+	result.add_multiple(deformation(it->first,plan),it->second); // recursion
+    }
 
   // now store result for future lookup
-  unsigned long h=hash.find(z_near);
+  h=hash.find(z_near);
   assert(h!=hash.empty); // it should have been added by |deformation_terms|
   def_formula[h]=result;
+  save('D',z_near,result);
 
   return result;
 } // |Rep_table::deformation|
@@ -953,7 +1221,7 @@ SR_poly twisted_KL_sum
   // compute cumulated KL polynomimals $P_{x,y}$ with $x\leq y$ survivors
 
   // start with computing KL polynomials for the entire block
-  std::vector<ext_kl::Pol> pool;
+  ext_kl::PolStore pool;
   ext_kl::KL_table twisted_KLV(eblock,pool);
   twisted_KLV.fill_columns(y+1); // fill table up to |y| inclusive
 
@@ -1035,7 +1303,7 @@ void Rep_table::add_block(ext_block::ext_block& block,
   // compute cumulated KL polynomimals $P_{x,y}$ with $x\leq y$ survivors
 
   // start with computing KL polynomials for the entire block
-  std::vector<ext_kl::Pol> pool;
+  ext_kl::PolStore pool;
   ext_kl::KL_table twisted_KLV(block,pool);
   twisted_KLV.fill_columns(); // block is complete, so fill everything
 
@@ -1085,6 +1353,7 @@ void Rep_table::add_block(ext_block::ext_block& block,
 	dest.add_term(sr(parent,block.z(x)),factor);
       }
       // since |dest| is a reference, the sum is stored at its destination
+      save('T',sr(parent,block.z(y)),dest);
     } // |if (y_index>=old_size)|
   } // |for (it)|
 } // |Rep_table::add_block| (extended block)
@@ -1094,6 +1363,7 @@ void Rep_table::add_block(ext_block::ext_block& block,
 SR_poly Rep_table::twisted_KL_column_at_s(StandardRepr z)
   // |z| must be inner-class-twist-fixed, nonzero and final
 {
+  load_cache();
   { RootNbr witness;
     if (is_zero(z,witness) or not is_final(z,witness))
       throw std::runtime_error("Representation zero or not final");
@@ -1123,6 +1393,7 @@ SR_poly Rep_table::twisted_KL_column_at_s(StandardRepr z)
 SR_poly Rep_table::twisted_deformation_terms
   (param_block& block,BlockElt entry_elem)
 {
+  load_cache();
   const auto& delta = innerClass().distinguished();
   const auto sr_y = sr(block,entry_elem);
 
@@ -1176,6 +1447,7 @@ SR_poly Rep_table::twisted_deformation_terms
 
 SR_poly Rep_table::twisted_deformation (StandardRepr z)
 {
+  load_cache();
   const auto& delta = innerClass().distinguished();
   RationalList rp=reducibility_points(z);
   bool flip_start=false; // whether a flip in descending to first point
@@ -1232,6 +1504,7 @@ SR_poly Rep_table::twisted_deformation (StandardRepr z)
     unsigned long h=hash.find(z);
     assert(h!=hash.empty); // it should have been added by |deformation_terms|
     twisted_def_formula[h]=result;
+    save('U',z,result);
   }
 
   return flip_start // if so we must multiply the stored value by $s$
@@ -1239,6 +1512,224 @@ SR_poly Rep_table::twisted_deformation (StandardRepr z)
     : result;
 } // |Rep_table::twisted_deformation|
 
+/*
+  Persistent cache of |Rep_table| results.
+
+  When a cache directory is set, each |Rep_table| appends the results it
+  computes to a file in that directory, whose name is derived from a key
+  identifying the root datum, inner class and real form; the full key is
+  stored in the file header, and a file with a different key is not used.
+  File name and header are as for the caches of the \.{kgb} module.
+  When a |Rep_table| is first used, results from the file are loaded, so that
+  a session repeating computations of an earlier one starts with those
+  results known. The file consists of the header (a magic number, the key
+  size and key) followed by records, each a kind letter, a parameter and a
+  polynomial, with for kind 'K' also the length of the parameter before the
+  polynomial. Kinds 'K' and 'T' record |KL_list| respectively
+  |twisted_KLV_list| entries, 'D' and 'U' |def_formula| and
+  |twisted_def_formula| entries. Numbers are written using |basic_io|, 4
+  bytes little-endian, but 8 bytes for |gamma|. Since 'K' records for all
+  survivors of a block are written together, before any other records
+  referring to them, the data loaded has the same consistency as data
+  computed. A record that was incompletely written (the process was killed
+  for instance) is ignored, and removed from the file.
+*/
+
+// the key for the cache file: root datum, inner class, real form and base point
+std::vector<int> Rep_table::cache_key() const
+{
+  const RootDatum& rd = rootDatum();
+  std::vector<int> key;
+  key.push_back(cache_format);
+  key.push_back(rd.rank());
+  key.push_back(rd.semisimpleRank());
+  for (weyl::Generator s=0; s<rd.semisimpleRank(); ++s)
+  {
+    const Weight& alpha = rd.simpleRoot(s);
+    key.insert(key.end(),alpha.begin(),alpha.end());
+    const Coweight& alpha_v = rd.simpleCoroot(s);
+    key.insert(key.end(),alpha_v.begin(),alpha_v.end());
+  }
+  const WeightInvolution& delta = innerClass().distinguished();
+  for (unsigned int i=0; i<delta.numRows(); ++i)
+    for (unsigned int j=0; j<delta.numColumns(); ++j)
+      key.push_back(delta(i,j));
+  key.push_back(realGroup().realForm());
+  const RatCoweight g_rho_check = realGroup().g_rho_check();
+  key.insert(key.end(),
+	     g_rho_check.numerator().begin(),g_rho_check.numerator().end());
+  key.push_back(g_rho_check.denominator());
+  const TorusPart x0 = realGroup().x0_torus_part();
+  key.push_back(x0.size());
+  key.push_back(x0.data().to_ulong());
+  return key;
+}
+
+void Rep_table::load_cache()
+{
+  if (cache_loaded or cache_name.empty())
+    return;
+  cache_loaded = true; // whatever happens below, don't come here again
+
+  using basic_io::read_bytes;
+  const std::vector<int> key = cache_key();
+  std::streamoff good_end = 0; // size of the part of the file that is valid
+  {
+    std::ifstream in(cache_name.c_str(),std::ios_base::binary);
+    if (in.is_open())
+    {
+      bool match = kgb::cache_header_matches(in,key);
+      if (in.good() and not match)
+      {
+	std::cerr << "Cache file " << cache_name
+		  << " is for another real form; not using it." << std::endl;
+	cache_name.clear();
+	return;
+      }
+      if (in.good()) // then the header is fine; read records until the end
+	try
+	{
+	  good_end = in.tellg();
+	  for (int kind; (kind=in.get())!=EOF; good_end = in.tellg())
+	  {
+	    const StandardRepr z = read_parameter(in);
+	    const unsigned int length = kind=='K' ? read_bytes<4>(in) : 0;
+	    const SR_poly P = read_poly(in); // throws if |in| fails
+	    if (kind=='K')
+	    {
+	      const unsigned long h = hash.match(z);
+	      lengths.resize(hash.size());
+	      KL_list.resize(hash.size(),SR_poly(repr_less()));
+	      def_formula.resize(hash.size(),SR_poly(repr_less()));
+	      lengths[h] = length;
+	      KL_list[h] = P;
+	      continue;
+	    }
+	    const unsigned long h = hash.find(z);
+	    if (h==hash.empty) // cannot happen for a file we wrote; ignore
+	      continue;
+	    if (kind=='D')
+	      def_formula[h] = P;
+	    else if (kind=='T' or kind=='U')
+	    {
+	      if (twisted_KLV_list.size()<hash.size())
+	      {
+		twisted_KLV_list.resize(hash.size(),SR_poly(repr_less()));
+		twisted_def_formula.resize(hash.size(),SR_poly(repr_less()));
+	      }
+	      (kind=='T' ? twisted_KLV_list : twisted_def_formula)[h] = P;
+	    }
+	    else
+	      throw std::runtime_error("unknown record kind");
+	  }
+	}
+	catch (std::runtime_error&) {} // ignore the remainder of the file
+    }
+  }
+
+  if (good_end==0) // no (valid) file was present; start one
+  {
+    cache_out.open(cache_name.c_str(),
+		   std::ios_base::out | std::ios_base::trunc
+		   | std::ios_base::binary);
+    kgb::write_cache_header(cache_out,key);
+    cache_out.flush();
+    if (not cache_out.good())
+    {
+      std::cerr << "Could not write cache file " << cache_name
+		<< "; not caching results." << std::endl;
+      cache_name.clear();
+      cache_out.close();
+    }
+  }
+  else if (truncate(cache_name.c_str(),good_end)!=0) // drop incomplete tail
+    cache_name.clear(); // don't append to a file we cannot repair
+  else
+    cache_out.open(cache_name.c_str(),
+		   std::ios_base::out | std::ios_base::app
+		   | std::ios_base::binary);
+}
+
+/*
+  Append a record for |z| and |P| to the cache file, if there is one. The file
+  stays open in |cache_out| from |load_cache| on; we flush after each record,
+  so that an interrupted session leaves at most one incomplete record.
+*/
+void Rep_table::save(char kind, const StandardRepr& z, const SR_poly& P)
+{
+  if (cache_name.empty())
+    return;
+  cache_out.put(kind);
+  write(cache_out,z);
+  if (kind=='K')
+    basic_io::put_int(lengths[hash.find(z)],cache_out);
+  write(cache_out,P);
+  cache_out.flush();
+  if (not cache_out.good())
+  {
+    std::cerr << "Failure writing cache file " << cache_name
+	      << "; no longer caching results." << std::endl;
+    cache_name.clear();
+    cache_out.close();
+  }
+}
+
+// parameters are written as |x|, then $\lambda-\rho$, then |gamma|
+void Rep_table::write(std::ostream& out, const StandardRepr& z) const
+{
+  basic_io::put_int(z.x(),out);
+  const Weight lr = lambda_rho(z);
+  for (unsigned int i=0; i<lr.size(); ++i)
+    basic_io::put_int(lr[i],out);
+  const RatWeight& gamma = z.gamma();
+  for (unsigned int i=0; i<gamma.size(); ++i)
+    basic_io::write_bytes<8>(gamma.numerator()[i],out);
+  basic_io::write_bytes<8>(gamma.denominator(),out);
+}
+
+void Rep_table::write(std::ostream& out, const SR_poly& P) const
+{
+  basic_io::put_int(P.size(),out);
+  for (SR_poly::const_iterator it=P.begin(); it!=P.end(); ++it)
+  {
+    write(out,it->first);
+    basic_io::put_int(it->second.e(),out);
+    basic_io::put_int(it->second.s(),out);
+  }
+}
+
+StandardRepr Rep_table::read_parameter(std::istream& in) const
+{
+  using basic_io::read_bytes;
+  const KGBElt x = read_bytes<4>(in);
+  Weight lr(rank());
+  for (unsigned int i=0; i<lr.size(); ++i)
+    lr[i] = static_cast<int>(read_bytes<4>(in));
+  Ratvec_Numer_t num(rank());
+  for (unsigned int i=0; i<num.size(); ++i)
+    num[i] = static_cast<arithmetic::Numer_t>(read_bytes<8>(in));
+  const auto denom = static_cast<arithmetic::Numer_t>(read_bytes<8>(in));
+  if (not in.good() or x>=kgb().size() or denom<=0)
+    throw std::runtime_error("Incomplete or corrupt cache record");
+  return sr_gamma(x,lr,RatWeight(num,denom));
+}
+
+SR_poly Rep_table::read_poly(std::istream& in) const
+{
+  SR_poly result(repr_less());
+  const unsigned int n = basic_io::read_bytes<4>(in);
+  for (unsigned int i=0; i<n and in.good(); ++i)
+  {
+    const StandardRepr z = read_parameter(in);
+    const int e = static_cast<int>(basic_io::read_bytes<4>(in));
+    const int s = static_cast<int>(basic_io::read_bytes<4>(in));
+    result.add_term(z,Split_integer(e,s));
+  }
+  if (not in.good())
+    throw std::runtime_error("Incomplete cache record");
+  return result;
+}
+
 std::ostream& Rep_context::print (std::ostream& str,const StandardRepr& z)
   const
 {
@@ -1255,5 +1746,29 @@ std::ostream& Rep_context::print (std::ostream& str,const SR_poly& P) const
 }
 
 
+const std::string& cache_directory() { return Rep_cache_directory; }
+
+/*
+  Have |Rep_table| objects constructed after this call keep their results in
+  a file in directory |dir| (which must exist), and load results from such a
+  file left by earlier sessions. An empty |dir| switches this off.
+*/
+void set_cache_directory(const std::string& dir)
+{
+  Rep_cache_directory=dir;
+}
+
+size_t block_cache_budget() { return Rep_block_budget; }
+
+/*
+  Set the memory, in bytes, that each |Rep_table| may use for the partial
+  blocks it keeps for reuse at translated parameters (see |Rep_table::below|).
+  A budget of 0 keeps only the most recent block, which is always kept.
+*/
+void set_block_cache_budget(size_t bytes)
+{
+  Rep_block_budget=bytes;
+}
+
   } // |namespace repr|
 } // |namespace atlas|
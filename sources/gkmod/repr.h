@@ -12,6 +12,11 @@
 #define REPR_H
 
 #include <iostream>
+#include <fstream> // |std::ofstream| for the persistent cache
+#include <string>
+#include <map>
+#include <deque>
+#include <memory> // |std::unique_ptr| in |block_cache|
 
 #include "../Atlas.h"
 
@@ -208,10 +213,18 @@ class Rep_table : public Rep_context
   std::vector<SR_poly> twisted_KLV_list; // values at twist-fixed |hash|s only
   std::vector<SR_poly> twisted_def_formula; // idem
 
+  std::string cache_name; // file keeping results across sessions, if any
+  bool cache_loaded; // whether the results in that file have been read
+  std::ofstream cache_out; // open for appending to that file, once loaded
+
+  // partial blocks kept for reuse at translated parameters, see |below|
+  typedef std::pair<KGBElt,RatWeight> block_key; // $x$ and $\gamma-\lambda$
+  std::map<block_key,std::unique_ptr<param_block> > block_cache;
+  std::deque<block_key> block_cache_order; // oldest first, for eviction
+
  public:
-  Rep_table(RealReductiveGroup &G)
-    : Rep_context(G), pool(), hash(pool), KL_list(), def_formula()
-  {}
+  Rep_table(RealReductiveGroup &G);
+  ~Rep_table(); // defined where |param_block| is a complete type
 
   unsigned int length(StandardRepr z); // by value
 
@@ -233,9 +246,34 @@ class Rep_table : public Rep_context
   // here |block| is non-|const| as the method generates KL polynomials in it
   // and |survivors| is non-|const| because the method computes and exports it
 
+  // partial block below |z|, maybe a translate of one built earlier
+  param_block& below(const StandardRepr& z);
+  block_key key_of(StandardRepr z) const; // by value, made dominant
+  param_block* cached_block(const StandardRepr& z); // translated, or null
+  param_block& store_block(const StandardRepr& z,
+			   std::unique_ptr<param_block>&& block);
+
+  // deformation terms found by |plan_deformation|, by |hash| index of the
+  // parameter at the last reducibility point (where |def_formula| is stored)
+  typedef std::map<unsigned long,SR_poly> deformation_plan;
+  struct Block_builder; // function object to build blocks, possibly in threads
+
+  void plan_deformation(const StandardRepr& z, deformation_plan& plan);
+  SR_poly deformation(const StandardRepr& z, const deformation_plan* plan);
+
   void add_block(ext_block::ext_block& block, param_block& parent);
   // here |block| is non-|const|; the method generates twisted KLV polys in it
 
+  // persistent cache of results in file |cache_name|, see |cache_directory|
+  std::vector<int> cache_key() const; // identifies real form, for the file
+  void load_cache(); // read results stored by earlier sessions, first time
+  void save(char kind, const StandardRepr& z, const SR_poly& P); // append
+
+  void write(std::ostream& out, const StandardRepr& z) const;
+  void write(std::ostream& out, const SR_poly& P) const;
+  StandardRepr read_parameter(std::istream& in) const;
+  SR_poly read_poly(std::istream& in) const;
+
 }; // |Rep_table|
 
 
@@ -250,6 +288,15 @@ Weight Cayley_shift (const InnerClass& G,
 SR_poly twisted_KL_column_at_s
   (const Rep_context& rc, StandardRepr z, const WeightInvolution& delta);
 
+// directory where |Rep_table|s keep files with their results, so that later
+// sessions for the same real form can reuse them; empty (default) for none
+const std::string& cache_directory();
+void set_cache_directory(const std::string& dir);
+
+// memory in bytes that each |Rep_table| may use for partial blocks it keeps
+size_t block_cache_budget(); // 64 MiB by default
+void set_block_cache_budget(size_t bytes);
+
 } // |namespace repr|
 
 } // |namespace atlas|
@@ -14,6 +14,8 @@
 #include <iostream>
 
 #include "filekl_in.h"	// for alternative |wGraph| function
+#include "parallel.h"	// for filling the cells concurrently
+#include "profile.h"
 
 namespace atlas {
 
@@ -67,9 +69,42 @@ void WGraph::resize(size_t n)
   d_descent.resize(n);
 }
 
+// The function object passed to |parallel::for_each_index| by the constructor
+struct DecomposedWGraph::Cell_filler
+{
+  const WGraph& wg;
+  DecomposedWGraph& dwg;
+  const std::vector<unsigned int>& relno;
+  Cell_filler(const WGraph& wg, DecomposedWGraph& dwg,
+	      const std::vector<unsigned int>& relno)
+    : wg(wg), dwg(dwg), relno(relno) {}
+  void operator() (size_t n);
+}; // |struct DecomposedWGraph::Cell_filler|
+
+void DecomposedWGraph::Cell_filler::operator() (size_t n)
+{
+  const std::vector<BlockElt>& idn=dwg.d_id[n];
+  WGraph& cur_cell = dwg.d_cell[n];
+  for (size_t z=0; z<idn.size(); ++z)
+  {
+    size_t y = idn[z]; // |relno[y]==z|
+    const graph::EdgeList& edge = wg.edgeList(y);
+    const WCoeffList& coeff = wg.coeffList(y);
+    graph::EdgeList& cur_el = cur_cell.edgeList(z);
+    WCoeffList& cur_cl = cur_cell.coeffList(z);
+    for (size_t k = 0; k < edge.size(); ++k)
+      if (dwg.d_part[edge[k]]==n) // only look at edges within this cell
+      {
+	cur_el.push_back(relno[edge[k]]);
+	cur_cl.push_back(     coeff[k]);
+      }
+  } // for (z)
+} // |DecomposedWGraph::Cell_filler::operator()|
+
 DecomposedWGraph::DecomposedWGraph(const WGraph& wg)
   : d_cell(), d_part(wg.size()), d_id(), d_induced()
 {
+  profile::phase timer("W cells");
   Partition pi;
   wg.cells(pi,&d_induced); // |OrientedGraph::cells| does the real work
 
@@ -100,26 +135,10 @@ DecomposedWGraph::DecomposedWGraph(const WGraph& wg)
   }
   // make sure all values |relno[y]| are defined before proceeding
 
-  for (i.rewind(); i(); ++i)
-  {
-    cell_no n=d_part[*i->first]; // cell number, constant through next loop
-    for (Partition::iterator::SubIterator
-	   j=i->first; j!=i->second; ++j)
-    {
-      size_t y = *j; size_t z=relno[y]; // |z==j-i->first|
-      const graph::EdgeList& edge = wg.edgeList(y);
-      const WCoeffList& coeff = wg.coeffList(y);
-      graph::EdgeList& cur_el = d_cell[n].edgeList(z);
-      WCoeffList& cur_cl = d_cell[n].coeffList(z);
-      for (size_t k = 0; k < edge.size(); ++k)
-	if (d_part[edge[k]]==n) // only look at edges within this cell
-	{
-	  cur_el.push_back(relno[edge[k]]);
-	  cur_cl.push_back(     coeff[k]);
-	}
-    } // for (j)
-  } // for (i)
-
+  // each cell only writes its own edge lists, so cells can be done in parallel
+  Cell_filler filler(wg,*this,relno);
+  parallel::for_each_index(0,d_cell.size(),filler);
+  timer.count("cells",d_cell.size());
 }
 
 } // |namespace wgraph|
@@ -133,72 +152,96 @@ DecomposedWGraph::DecomposedWGraph(const WGraph& wg)
 namespace wgraph {
 
 
+namespace {
+
+// The function object passed to |parallel::for_each_index| by |cells|
+struct Cell_extractor
+{
+  typedef Partition::iterator::SubIterator SubIterator;
+  std::vector<WGraph>& wc;
+  size_t base;
+  const WGraph& wg;
+  const Partition& pi;
+  const std::vector<std::pair<SubIterator,SubIterator> >& range;
+  Cell_extractor(std::vector<WGraph>& wc, size_t base, const WGraph& wg,
+		 const Partition& pi,
+		 const std::vector<std::pair<SubIterator,SubIterator> >& range)
+    : wc(wc), base(base), wg(wg), pi(pi), range(range) {}
+  void operator() (size_t n);
+}; // |struct Cell_extractor|
+
+void Cell_extractor::operator() (size_t n)
+{
+  SubIterator first = range[n].first, last = range[n].second;
+  WGraph& wci = wc[base+n];
+
+  /* looping over |z| rather than using |*i| directly implements the
+     renumbering of each cell (what was |y=*(first+z)| becomes just |z|)
+  */
+  for (size_t z = 0; z < wci.size(); ++z)
+  {
+    size_t y = first[z];
+    wci.descent(z) = wg.descent(y);
+    const graph::EdgeList& el = wg.edgeList(y);
+    graph::EdgeList& eli = wci.edgeList(z);
+    const WCoeffList& cl = wg.coeffList(y);
+    WCoeffList& cli = wci.coeffList(z);
+    for (size_t j = 0; j < el.size(); ++j) {
+      size_t x = el[j];
+      if (pi.class_of(x) != pi.class_of(y))
+	continue; // ignore edge leading out of the current cell
+      // find relative address of x in this class
+      size_t xi = std::lower_bound(first,last,x) - first;
+      eli.push_back(xi);
+      cli.push_back(cl[j]);
+    }
+  } //for (z)
+} // |Cell_extractor::operator()|
+
+} // |namespace|
+
 /*
   Synopsis: puts in wc the cells of the W-graph wg.
 */
 void cells(std::vector<WGraph>& wc, const WGraph& wg)
 {
+  profile::phase timer("W cells");
   Partition pi;
   wg.cells(pi); // do not collect information about induced graph here
 
+  typedef Partition::iterator::SubIterator SubIterator;
+  std::vector<std::pair<SubIterator,SubIterator> > range;
+  range.reserve(pi.classCount());
   for (Partition::iterator i(pi); i(); ++i)
+    range.push_back(*i);
+
+  size_t base = wc.size(); // new cells are appended to those already present
+  wc.reserve(base+range.size());
+  for (size_t n=0; n<range.size(); ++n)
   {
     wc.push_back(WGraph(wg.rank()));
-    WGraph& wci = wc.back();
-    wci.resize(i->second - i->first);
+    wc.back().resize(range[n].second - range[n].first);
+  }
 
-    /* looping over |z| rather than using |*i| directly implements the
-       renumbering of each cell (what was |y=*(i->first+z)| becomes just |z|)
-    */
-    for (size_t z = 0; z < wci.size(); ++z)
-    {
-      size_t y = i->first[z];
-      wci.descent(z) = wg.descent(y);
-      const graph::EdgeList& el = wg.edgeList(y);
-      graph::EdgeList& eli = wci.edgeList(z);
-      const WCoeffList& cl = wg.coeffList(y);
-      WCoeffList& cli = wci.coeffList(z);
-      for (size_t j = 0; j < el.size(); ++j) {
-	size_t x = el[j];
-	if (pi.class_of(x) != pi.class_of(y))
-	  continue; // ignore edge leading out of the current cell
-	// find relative address of x in this class
-	size_t xi = std::lower_bound(i->first,i->second,x) - i->first;
-	eli.push_back(xi);
-	cli.push_back(cl[j]);
-      }
-    } //for (z)
-  } // for (i)
+  Cell_extractor extract(wc,base,wg,pi,range);
+  parallel::for_each_index(0,range.size(),extract);
+  timer.count("cells",range.size());
 
 } // cells
 
+namespace {
+
 /* The following function is an alternative to the function |wGraph| defined
    in kl.cpp. Here we do not assume that a KLContext is available, but that
    binary files with information about the block, matrix, and KL polynomials
    are avaialble. As a consequence we must redo the work of
    |kl::Helper::fillMuRow| as well as that to the mentioned |wGraph| function.
+   The files are accessed through |mi| and |poli|, which may either read them
+   as streams, or map them into memory.
 */
-WGraph wGraph
-  ( std::ifstream& block_file
-  , std::ifstream& matrix_file
-  , std::ifstream& KL_file)
+template<typename Matrix_info, typename Polynomial_info>
+  WGraph wGraph_from_files(Matrix_info& mi, const Polynomial_info& poli)
 {
-  typedef std::auto_ptr<filekl::polynomial_info> pol_aptr;
-
-  filekl::matrix_info mi(block_file,matrix_file);
-  pol_aptr pol_p(NULL);
-
-  try
-  { pol_p=pol_aptr(new filekl::cached_pol_info(KL_file));
-  }
-  catch (std::exception& e)
-  {
-    std::cerr << "Failed to use cached polynomials: " << e.what() << std::endl;
-    pol_p=pol_aptr(new filekl::polynomial_info(KL_file));
-  }
-
-  filekl::polynomial_info& poli=*pol_p;
-
   size_t max_mu=1;                       // maximal mu found
   std::pair<BlockElt,BlockElt> max_pair; // corresponding (x,y)
 
@@ -281,6 +324,44 @@ WGraph wGraph
   return result;
 }
 
+} // |namespace|
+
+WGraph wGraph
+  ( std::ifstream& block_file
+  , std::ifstream& matrix_file
+  , std::ifstream& KL_file)
+{
+  typedef std::auto_ptr<filekl::polynomial_info> pol_aptr;
+
+  filekl::matrix_info mi(block_file,matrix_file);
+  pol_aptr pol_p(NULL);
+
+  try
+  { pol_p=pol_aptr(new filekl::cached_pol_info(KL_file));
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "Failed to use cached polynomials: " << e.what() << std::endl;
+    pol_p=pol_aptr(new filekl::polynomial_info(KL_file));
+  }
+
+  return wGraph_from_files(mi,*pol_p);
+}
+
+/* With memory-mapped files no preparatory reading of the files is needed; in
+   particular the degrees of polynomials need not be cached, as they can be
+   found directly from the index in the mapped polynomial file.
+*/
+WGraph wGraph
+  ( const std::string& block_file
+  , const std::string& matrix_file
+  , const std::string& KL_file)
+{
+  filekl::mapped_matrix_info mi(block_file,matrix_file);
+  filekl::mapped_polynomial_info poli(KL_file);
+  return wGraph_from_files(mi,poli);
+}
+
 
 } // |namespace wgraph|
 
@@ -36,6 +36,12 @@ WGraph wGraph
   , std::ifstream& matrix_file
   , std::ifstream& KL_file);
 
+// the same, but mapping the files named into memory instead of reading them
+WGraph wGraph
+  ( const std::string& block_file
+  , const std::string& matrix_file
+  , const std::string& KL_file);
+
 }
 
 /******** type definitions **************************************************/
@@ -115,6 +121,8 @@ class DecomposedWGraph
 
   graph::OrientedGraph d_induced; // induced graph on cells
 
+  struct Cell_filler; // fills the edges of one cell, used in the constructor
+
  public:
 
 // constructors and destructors
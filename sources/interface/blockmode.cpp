@@ -18,6 +18,7 @@
 #include "output.h"
 #include "error.h"
 #include "helpmode.h"
+#include "input.h"
 #include "interactive.h"
 #include "io.h"
 #include "ioutils.h"
@@ -76,6 +77,7 @@ namespace {
   void kllist_f();
   void primkl_f();
   void klwrite_f();
+  void klstream_f();
   void wgraph_f();
   void wcells_f();
 
@@ -140,6 +142,9 @@ CommandNode blockNode()
   result.add("primkl",primkl_f,
 	     "prints the KL polynomials for primitive pairs",std_help);
   result.add("klwrite",klwrite_f,"writes the KL polynomials to disk",std_help);
+  result.add("klstream",klstream_f,
+	     "computes the KL polynomials writing rows to disk on the fly",
+	     std_help);
   result.add("wcells",wcells_f,
 	     "prints the Kazhdan-Lusztig cells for the block",std_help);
   result.add("wgraph",wgraph_f,"prints the W-graph for the block",std_help);
@@ -176,7 +181,12 @@ Block& currentBlock()
 
 kl::KLContext& currentKL()
 {
-  return currentBlock().klc(currentBlock().size()-1,true);
+  Block& block = currentBlock();
+  kl::KLContext& klc = block.KL_context();
+  // this top-level computation is the one that may be checkpointed
+  klc.set_checkpoint(kl::checkpoint_file(),kl::checkpoint_interval());
+  klc.fill(block.size()-1,true);
+  return klc;
 }
 
 const wgraph::WGraph& currentWGraph()
@@ -537,6 +547,50 @@ void klwrite_f()
   }
 }
 
+/*
+  Compute the KL polynomials in a separate |KLContext|, writing the rows to the
+  matrix file as they are completed, and evicting them from memory when the
+  rows kept exceed a given budget. This allows writing binary files for
+  blocks whose KL matrix does not fit in memory.
+*/
+void klstream_f()
+{
+  std::fstream matrix_out;
+  while (true)
+  {
+    std::string name = interactive::getFileName("File name for matrix output: ");
+    if (name.empty())
+      return; // without a matrix file there is nothing to stream to
+    matrix_out.open(name.c_str(), std::ios_base::in | std::ios_base::out
+		    | std::ios_base::trunc | std::ios_base::binary);
+    if (matrix_out.is_open())
+      break;
+    std::cerr << "Failed to open file for writing, try again.\n";
+  }
+  std::ofstream coefficient_out;
+  interactive::open_binary_file
+    (coefficient_out,"File name for polynomial output: ");
+
+  input::InputBuffer& ib = interactive::common_input();
+  ib.getline("memory for KL matrix rows in MB: ",true);
+  unsigned long megabytes;
+  if (not (ib >> megabytes))
+    megabytes=0; // keep no more rows than needed
+
+  filekl::matrix_stream stream(matrix_out);
+  kl::KLContext klc(currentBlock());
+  klc.stream_rows(stream,size_t(megabytes)<<20);
+  klc.fill(true);
+  stream.finish();
+
+  if (coefficient_out.is_open())
+  {
+    std::cout << "Writing polynomial coefficients... " << std::flush;
+    filekl::write_KL_store(klc.polStore(),coefficient_out);
+    std::cout << "Done." << std::endl;
+  }
+}
+
 // Print the W-graph corresponding to a block.
 void wgraph_f()
 {
@@ -10,10 +10,17 @@
 #include "emptymode.h"
 
 #include <iostream>
+#include <string>
+#include <stdexcept>
 
 #include "helpmode.h"
 #include "io.h"
+#include "input.h"
 #include "interactive.h"
+#include "parallel.h"
+#include "profile.h"
+#include "kl.h"
+#include "kgb.h"
 #include "wgraph.h"
 #include "wgraph_io.h"
 
@@ -43,6 +50,16 @@ namespace {
   void type_f();
   void extract_graph_f();
   void extract_cells_f();
+  void threads_f();
+  void klcheckpoint_f();
+  void kgbcache_f();
+  void profile_f();
+  void profilejson_f();
+  void profilereset_f();
+
+  wgraph::WGraph read_W_graph(ioutils::InputFile& block_file,
+			      ioutils::InputFile& matrix_file,
+			      ioutils::InputFile& polynomial_file);
 
 } // |namespace|
 
@@ -76,6 +93,18 @@ CommandNode emptyNode()
 	     "reads block and KL binary files and prints W-graph",use_tag);
   result.add("extract-cells",extract_cells_f,
 	     "reads block and KL binary files and prints W-cells",use_tag);
+  result.add("threads",threads_f,
+	     "sets the number of threads used for computations",std_help);
+  result.add("klcheckpoint",klcheckpoint_f,
+	     "sets a file for saving and resuming KL computations",std_help);
+  result.add("kgbcache",kgbcache_f,
+	     "sets a directory for caching KGB sets and blocks",std_help);
+  result.add("profile",profile_f,
+	     "prints time and counters recorded per computation phase",std_help);
+  result.add("profilejson",profilejson_f,
+	     "writes time and counters per computation phase as JSON",std_help);
+  result.add("profilereset",profilereset_f,
+	     "forgets the time and counters recorded so far",std_help);
 
   test::addTestCommands<EmptymodeTag>(result);
   return result;
@@ -112,7 +141,7 @@ void extract_graph_f()
   ioutils::InputFile polynomial_file("polynomial information");
   ioutils::OutputFile file;
 
-  wgraph::WGraph wg=wgraph::wGraph(block_file,matrix_file,polynomial_file);
+  wgraph::WGraph wg=read_W_graph(block_file,matrix_file,polynomial_file);
   wgraph_io::printWGraph(file,wg);
 }
 
@@ -123,11 +152,80 @@ void extract_cells_f()
   ioutils::InputFile polynomial_file("polynomial information");
   ioutils::OutputFile file;
 
-  wgraph::WGraph wg=wgraph::wGraph(block_file,matrix_file,polynomial_file);
+  wgraph::WGraph wg=read_W_graph(block_file,matrix_file,polynomial_file);
   wgraph::DecomposedWGraph dg(wg);
   wgraph_io::printWDecomposition(file,dg);
 }
 
+void threads_f()
+{
+  std::cout << "currently using " << parallel::thread_count()
+	    << " thread(s), out of " << parallel::hardware_threads()
+	    << " available." << std::endl;
+  unsigned long n = interactive::get_bounded_int
+    (interactive::common_input(),
+     "number of threads (0 for all available): ",
+     1025); // allow oversubscription, within reason
+  parallel::set_thread_count(n);
+}
+
+void klcheckpoint_f()
+{
+  if (kl::checkpoint_file().empty())
+    std::cout << "currently not checkpointing KL computations." << std::endl;
+  else
+    std::cout << "currently checkpointing KL computations to file "
+	      << kl::checkpoint_file() << '.' << std::endl;
+
+  input::InputBuffer& ib = interactive::common_input();
+  ib.getline("checkpoint file (none to switch off): ",true);
+  std::string name;
+  ib >> name;
+
+  unsigned int seconds=0;
+  if (not name.empty())
+  {
+    ib.getline("minimal number of seconds between checkpoints: ",true);
+    if (not (ib >> seconds))
+      seconds=0;
+  }
+
+  kl::set_checkpoint(name,seconds);
+}
+
+void kgbcache_f()
+{
+  if (kgb::cache_directory().empty())
+    std::cout << "currently not caching KGB sets and blocks." << std::endl;
+  else
+    std::cout << "currently caching KGB sets and blocks in directory "
+	      << kgb::cache_directory() << '.' << std::endl;
+
+  input::InputBuffer& ib = interactive::common_input();
+  ib.getline("cache directory (none to switch off): ",true);
+  std::string name;
+  ib >> name;
+
+  kgb::set_cache_directory(name);
+}
+
+void profile_f()
+{
+  ioutils::OutputFile file;
+  profile::print(file);
+}
+
+void profilejson_f()
+{
+  ioutils::OutputFile file;
+  profile::write_json(file);
+}
+
+void profilereset_f()
+{
+  profile::reset();
+}
+
 
 /****************************************************************************
 
@@ -136,10 +234,32 @@ void extract_cells_f()
   This section contains some utility functions used in this module :
 
     - printVersion() : prints version info on startup;
+    - read_W_graph() : reads the W-graph from binary files;
 
 *****************************************************************************/
 
 
+/*
+  Read the W-graph from binary files for which the user has been prompted,
+  preferably by mapping them into memory, otherwise by reading the streams.
+*/
+wgraph::WGraph read_W_graph(ioutils::InputFile& block_file,
+			    ioutils::InputFile& matrix_file,
+			    ioutils::InputFile& polynomial_file)
+{
+  try
+  {
+    return wgraph::wGraph
+      (block_file.name(),matrix_file.name(),polynomial_file.name());
+  }
+  catch (std::runtime_error& e)
+  {
+    std::cerr << "Cannot map files into memory (" << e.what()
+	      << "), reading them instead." << std::endl;
+    return wgraph::wGraph(block_file,matrix_file,polynomial_file);
+  }
+}
+
 /*
   Prints an opening message and the version number.
 */
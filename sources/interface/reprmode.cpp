@@ -382,7 +382,7 @@ void extkl_f()
   auto& block = current_param_block();
   ext_block::ext_block eblock(current_inner_class(),block,
 			      currentRealGroup().kgb(),delta,true);
-  std::vector<ext_kl::Pol> pool;
+  ext_kl::PolStore pool;
   ext_kl::KL_table twisted_KLV(eblock,pool);
   twisted_KLV.fill_columns();
 
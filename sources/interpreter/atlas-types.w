@@ -445,7 +445,8 @@ void ann_mod_wrapper(expression_base::level l)
   shared_matrix m=get<matrix_value>();
 @)
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<matrix_value>(annihilator_modulo(m->val,d->val)));
+    push_value(std::make_shared<matrix_value>@|
+      (annihilator_modulo(m->val,d->int_val())));
 }
 
 @ Next a simple administrative routine, introduced because we could not handle
@@ -978,7 +979,7 @@ apply a shift by the number of positive roots here.
 
 @< Local function definitions @>=
 void root_wrapper(expression_base::level l)
-{ int root_index = get<int_value>()->val;
+{ int root_index = get<int_value>()->int_val();
   shared_root_datum rd(get<root_datum_value>());
   RootNbr npr = rd->val.numPosRoots();
   RootNbr alpha = npr+root_index;
@@ -988,7 +989,7 @@ void root_wrapper(expression_base::level l)
      push_value(std::make_shared<vector_value>(rd->val.root(alpha)));
 }
 void coroot_wrapper(expression_base::level l)
-{ int root_index = get<int_value>()->val;
+{ int root_index = get<int_value>()->int_val();
   shared_root_datum rd(get<root_datum_value>());
   RootNbr npr = rd->val.numPosRoots();
   RootNbr alpha = npr+root_index;
@@ -1117,7 +1118,7 @@ basis, which is easier since they are rational vectors.
 
 @< Local function definitions @>=
 void fundamental_weight_wrapper(expression_base::level l)
-{ int i= get<int_value>()->val;
+{ int i= get<int_value>()->int_val();
   shared_root_datum rd(get<root_datum_value>());
   if (unsigned(i)>=rd->val.semisimpleRank())
     throw runtime_error("Invalid index "+str(i));
@@ -1127,7 +1128,7 @@ void fundamental_weight_wrapper(expression_base::level l)
 }
 @)
 void fundamental_coweight_wrapper(expression_base::level l)
-{ int i= get<int_value>()->val;
+{ int i= get<int_value>()->int_val();
   shared_root_datum rd(get<root_datum_value>());
   if (unsigned(i)>=rd->val.semisimpleRank())
     throw runtime_error("Invalid index "+str(i));
@@ -2236,11 +2237,12 @@ As a special case we also provide the quasisplit form.
 void real_form_wrapper(expression_base::level l)
 { shared_int i(get<int_value>());
   shared_inner_class G = get<inner_class_value>();
-  if (size_t(i->val)>=G->val.numRealForms())
+  if (size_t(i->int_val())>=G->val.numRealForms())
     throw runtime_error ("Illegal real form number: "+str(i->val));
 @.Illegal real form number@>
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<real_form_value>(*G,G->interface.in(i->val)));
+    push_value(std::make_shared<real_form_value>@|
+      (*G,G->interface.in(i->int_val())));
 }
 @)
 void form_number_wrapper(expression_base::level l)
@@ -2405,7 +2407,7 @@ index. We also provide the dual quasisplit form.
 void dual_real_form_wrapper(expression_base::level l)
 { shared_int i(get<int_value>());
   shared_inner_class G = get<inner_class_value>();
-  if (size_t(i->val)>=G->val.numDualRealForms())
+  if (size_t(i->int_val())>=G->val.numDualRealForms())
     throw runtime_error ("Illegal dual real form number: "+str(i->val));
 @.Illegal dual real form number@>
   if (l==expression_base::no_value)
@@ -2413,7 +2415,7 @@ void dual_real_form_wrapper(expression_base::level l)
   inner_class_value G_check(*G,tags::DualTag());
    // tailor make an |inner_class_value|
   push_value(std::make_shared<real_form_value>@|
-    (G_check ,G->dual_interface.in(i->val)));
+    (G_check ,G->dual_interface.in(i->int_val())));
 }
 @)
 void dual_quasisplit_form_wrapper(expression_base::level l)
@@ -2626,13 +2628,13 @@ a valid index into its list of Cartan classes.
 void ic_Cartan_class_wrapper(expression_base::level l)
 { shared_int i(get<int_value>());
   shared_inner_class ic = get<inner_class_value>();
-  if (size_t(i->val)>=ic->val.numCartanClasses())
+  if (size_t(i->int_val())>=ic->val.numCartanClasses())
     throw runtime_error ("Illegal Cartan class number: "+str(i->val)
 @.Illegal Cartan class number@>
     +", this inner class only has "+str(ic->val.numCartanClasses())
     +" of them");
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<Cartan_class_value>(*ic,i->val));
+    push_value(std::make_shared<Cartan_class_value>(*ic,i->int_val()));
 }
 
 @ Alternatively (and this used to be the only way) one can provide a
@@ -2644,13 +2646,14 @@ containing inner class, and then get the Cartan class from there.
 void rf_Cartan_class_wrapper(expression_base::level l)
 { shared_int i(get<int_value>());
   shared_real_form rf= get<real_form_value>();
-  if (size_t(i->val)>=rf->val.numCartan())
+  if (size_t(i->int_val())>=rf->val.numCartan())
     throw runtime_error ("Illegal Cartan class number: "+str(i->val)
 @.Illegal Cartan class number@>
     +", this real form only has "+str(rf->val.numCartan())+" of them");
   BitMap cs=rf->val.Cartan_set();
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<Cartan_class_value>(rf->parent,cs.n_th(i->val)));
+    push_value(std::make_shared<Cartan_class_value>@|
+      (rf->parent,cs.n_th(i->int_val())));
 }
 
 @ Like the quasisplit real form for inner classes, there is a particular
@@ -3006,7 +3009,7 @@ void KGB_elt_value::print(std::ostream& out) const
 
 @< Local function def...@>=
 void KGB_elt_wrapper(expression_base::level l)
-{ int i = get<int_value>()->val;
+{ int i = get<int_value>()->int_val();
   own_real_form rf= non_const_get<real_form_value>();
   if (size_t(i)>=rf->val.KGB_size())
     throw runtime_error ("Inexistent KGB element: "+str(i));
@@ -3080,7 +3083,7 @@ void KGB_cross_wrapper(expression_base::level l)
 { own_KGB_elt x = get_own<KGB_elt_value>();
   const KGB& kgb=x->rf->kgb();
   RootNbr npr=kgb.rootDatum().numPosRoots();
-  RootNbr alpha = get_reflection_index(get<int_value>()->val,npr);
+  RootNbr alpha = get_reflection_index(get<int_value>()->int_val(),npr);
 @)
   if (l==expression_base::no_value)
     return;
@@ -3095,7 +3098,7 @@ void KGB_Cayley_wrapper(expression_base::level l)
 { own_KGB_elt x = get_own<KGB_elt_value>();
   const KGB& kgb=x->rf->kgb();
   RootNbr npr=kgb.rootDatum().numPosRoots();
-  RootNbr alpha = get_reflection_index(get<int_value>()->val,npr);
+  RootNbr alpha = get_reflection_index(get<int_value>()->int_val(),npr);
 @)
   if (l==expression_base::no_value)
     return;
@@ -3127,7 +3130,7 @@ void KGB_status_wrapper(expression_base::level l)
 { shared_KGB_elt x = get<KGB_elt_value>();
   const KGB& kgb=x->rf->kgb();
   RootNbr npr=kgb.rootDatum().numPosRoots();
-  RootNbr alpha = get_reflection_index(get<int_value>()->val,npr);
+  RootNbr alpha = get_reflection_index(get<int_value>()->int_val(),npr);
 @)
   if (l==expression_base::no_value)
     return;
@@ -3410,7 +3413,7 @@ void block_size_wrapper(expression_base::level l)
 void block_element_wrapper(expression_base::level l)
 { shared_int i(get<int_value>());
   shared_Block b = get<Block_value>();
-  BlockElt z = i->val; // extract value unsigned
+  BlockElt z = i->int_val(); // extract value unsigned
   if (z>=b->val.size())
     throw runtime_error
       ("Block element " +str(z) + " out of range (<" + str(b->val.size())+")");
@@ -3472,9 +3475,9 @@ a Weyl group generator with respect to a block element.
 
 @< Local function def...@>=
 void block_status_wrapper(expression_base::level l)
-{ BlockElt i = get<int_value>()->val;
+{ BlockElt i = get<int_value>()->int_val();
   shared_Block b = get<Block_value>();
-  unsigned int s = get<int_value>()->val;
+  unsigned int s = get<int_value>()->int_val();
   if (s>=b->rf->val.semisimpleRank())
     throw runtime_error ("Illegal simple reflection: "+str(s));
   if (i>=b->val.size())
@@ -3494,9 +3497,9 @@ void block_status_wrapper(expression_base::level l)
 @< Local function def...@>=
 
 void block_cross_wrapper(expression_base::level l)
-{ BlockElt i = get<int_value>()->val;
+{ BlockElt i = get<int_value>()->int_val();
   shared_Block b = get<Block_value>();
-  unsigned int s = get<int_value>()->val;
+  unsigned int s = get<int_value>()->int_val();
   if (s>=b->rf->val.semisimpleRank())
     throw runtime_error ("Illegal simple reflection: "+str(s));
   if (i>=b->val.size())
@@ -3510,15 +3513,15 @@ void block_cross_wrapper(expression_base::level l)
 void block_Cayley_wrapper(expression_base::level l)
 { shared_int i = get<int_value>();
   shared_Block b = get<Block_value>();
-  unsigned int s = get<int_value>()->val;
+  unsigned int s = get<int_value>()->int_val();
   if (s>=b->rf->val.semisimpleRank())
     throw runtime_error ("Illegal simple reflection: "+str(s));
-  if (static_cast<unsigned int>(i->val) >= b->val.size())
+  if (static_cast<unsigned int>(i->int_val()) >= b->val.size())
     throw runtime_error
       ("Block element " +str(i) + " out of range (<" + str(b->val.size())+")");
   if (l==expression_base::no_value)
     return;
-  BlockElt sx = b->val.cayley(s,i->val).first;
+  BlockElt sx = b->val.cayley(s,i->int_val()).first;
   if (sx==UndefBlock) // when undefined, return i to indicate so
     push_value(i);
   else
@@ -3528,15 +3531,15 @@ void block_Cayley_wrapper(expression_base::level l)
 void block_inverse_Cayley_wrapper(expression_base::level l)
 { shared_int i = get<int_value>();
   shared_Block b = get<Block_value>();
-  unsigned int s = get<int_value>()->val;
+  unsigned int s = get<int_value>()->int_val();
   if (s>=b->rf->val.semisimpleRank())
     throw runtime_error ("Illegal simple reflection: "+str(s));
-  if (static_cast<unsigned int>(i->val) >= b->val.size())
+  if (static_cast<unsigned int>(i->int_val()) >= b->val.size())
     throw runtime_error
       ("Block element " +str(i) + " out of range (<" + str(b->val.size())+")");
   if (l==expression_base::no_value)
     return;
-  BlockElt sx = b->val.inverseCayley(s,i->val).first;
+  BlockElt sx = b->val.inverseCayley(s,i->int_val()).first;
   if (sx==UndefBlock) // when undefined, return i to indicate so
     push_value(i);
   else
@@ -3795,7 +3798,7 @@ here, which present a single-minded interface to these transforms.
 @< Local function def...@>=
 void parameter_cross_wrapper(expression_base::level l)
 { shared_module_parameter p = get<module_parameter_value>();
-  int s = get<int_value>()->val;
+  int s = get<int_value>()->int_val();
   unsigned int r =
     rootdata::integrality_rank(p->rf->val.rootDatum(),p->val.gamma());
   if (static_cast<unsigned>(s)>=r)
@@ -3808,7 +3811,7 @@ void parameter_cross_wrapper(expression_base::level l)
 @)
 void parameter_Cayley_wrapper(expression_base::level l)
 { shared_module_parameter p = get<module_parameter_value>();
-  int s = get<int_value>()->val;
+  int s = get<int_value>()->int_val();
   unsigned int r =
     rootdata::integrality_rank(p->rf->val.rootDatum(),p->val.gamma());
   if (static_cast<unsigned>(s)>=r)
@@ -3821,7 +3824,7 @@ void parameter_Cayley_wrapper(expression_base::level l)
 
 void parameter_inv_Cayley_wrapper(expression_base::level l)
 { shared_module_parameter p = get<module_parameter_value>();
-  int s = get<int_value>()->val;
+  int s = get<int_value>()->int_val();
   unsigned int r =
     rootdata::integrality_rank(p->rf->val.rootDatum(),p->val.gamma());
   if (static_cast<unsigned>(s)>=r)
@@ -4062,7 +4065,7 @@ void KL_block_wrapper(expression_base::level l)
   polys->val.reserve(klc.polStore().size());
   for (size_t i=0; i<klc.polStore().size(); ++i)
   {
-    const kl::KLPol& pol = klc.polStore()[i];
+    const kl::KLPolRef pol = klc.polStore()[i];
     std::vector<int> coeffs(pol.size());
     for (size_t j=pol.size(); j-->0; )
       coeffs[j]=pol[j];
@@ -4141,7 +4144,7 @@ void partial_KL_block_wrapper(expression_base::level l)
   polys->val.reserve(klc.polStore().size());
   for (size_t i=0; i<klc.polStore().size(); ++i)
   {
-    const kl::KLPol& pol = klc.polStore()[i];
+    const kl::KLPolRef pol = klc.polStore()[i];
     std::vector<int> coeffs(pol.size());
     for (size_t j=pol.size(); j-->0; )
       coeffs[j]=pol[j];
@@ -4454,14 +4457,14 @@ split integers, and an explicit operator for converting back to a pair.
 @< Local function definitions @>=
 
 void int_to_split_coercion()
-{ int a=get<int_value>()->val;
+{ int a=get<int_value>()->int_val();
 @/push_value(std::make_shared<split_int_value>(Split_integer(a)));
 }
 @)
 void pair_to_split_coercion()
 { push_tuple_components();
-  int b=get<int_value>()->val;
-  int a=get<int_value>()->val;
+  int b=get<int_value>()->int_val();
+  int a=get<int_value>()->int_val();
   push_value(std::make_shared<split_int_value>(Split_integer(a,b)));
 }
 @)
@@ -4804,8 +4807,8 @@ correctly for it (albeit not in the fastest possible way).
 @< Local function... @>=
 
 void int_mult_virtual_module_wrapper(expression_base::level l)
-{ int c =
-    force<int_value>(execution_stack[execution_stack.size()-2].get())->val;
+{ int c = force<int_value>
+    (execution_stack[execution_stack.size()-2].get())->int_val();
   // below top
   if (c==0) // then do multiply by $0$ efficiently:
   { shared_virtual_module m = get<virtual_module_value>();
@@ -4939,7 +4942,7 @@ final representation into $K$-types, up to a given limit.
 
 @< Local function def...@>=
 void branch_wrapper(expression_base::level l)
-{ int bound = get<int_value>()->val;
+{ int bound = get<int_value>()->int_val();
   shared_module_parameter p = get<module_parameter_value>();
   const Rep_context rc = p->rc();
   RealReductiveGroup& G=p->rf->val;
@@ -5202,7 +5205,7 @@ void scale_extended_wrapper(expression_base::level l)
   rc.make_dominant(sr); // ensure this in case caller forgot
   bool flipped;
   sr = @;ext_block::scaled_extended_dominant
-    (rc,sr,delta->val,factor->val,flipped);
+    (rc,sr,delta->val,factor->rat_val(),flipped);
   push_value(std::make_shared<module_parameter_value>(p->rf,sr));
   push_value(whether(flipped));
   if (l==expression_base::single_value)
@@ -5316,7 +5319,7 @@ void raw_KL_wrapper (expression_base::level l)
   polys->val.reserve(klc.polStore().size());
   for (size_t i=0; i<klc.polStore().size(); ++i)
   {
-    const kl::KLPol& pol = klc.polStore()[i];
+    const kl::KLPolRef pol = klc.polStore()[i];
     std::vector<int> coeffs(pol.size());
     for (size_t j=pol.size(); j-->0; )
       coeffs[j]=pol[j];
@@ -5357,7 +5360,7 @@ void raw_dual_KL_wrapper (expression_base::level l)
   polys->val.reserve(klc.polStore().size());
   for (size_t i=0; i<klc.polStore().size(); ++i)
   {
-    const kl::KLPol& pol = klc.polStore()[i];
+    const kl::KLPolRef pol = klc.polStore()[i];
     std::vector<int> coeffs(pol.size());
     for (size_t j=pol.size(); j-->0; )
       coeffs[j]=pol[j];
@@ -5402,7 +5405,7 @@ void raw_ext_KL_wrapper (expression_base::level l)
   else
   {
     ext_block::ext_block eb(rc.innerClass(),block,rc.kgb(),delta->val);
-    std::vector<Polynomial<int> > pool;
+    ext_kl::PolStore pool;
     ext_kl::KL_table klt(eb,pool); klt.fill_columns();
   @)
     own_matrix M = std::make_shared<matrix_value>(int_Matrix(klt.size()));
@@ -5701,6 +5704,67 @@ void print_W_graph_wrapper(expression_base::level l)
 }
 
 
+@ The library records, for named phases of its computations (generating KGB
+sets and blocks, filling KL tables, deformation, and so on), the number of
+calls, the time spent, the largest resident memory size seen, the growth of
+the heap, and some counters of work done. The function |profile_data| gives
+these as a list of tuples (phase name, number of calls, microseconds,
+kilobytes resident, bytes of heap growth, counters), with counters given as
+(name, value) pairs. Since our integers are unbounded, these values are
+reported exactly, even for long computations. The function |profile_json|
+gives the same information as a JSON text, and |reset_profile| forgets all
+records.
+
+@h "profile.h"
+
+@< Local function def...@>=
+void profile_data_wrapper(expression_base::level l)
+{ const auto recs = profile::records();
+  if (l==expression_base::no_value)
+    return;
+  own_row result = std::make_shared<row_value>(0);
+  result->val.reserve(recs.size());
+  for (auto it=recs.begin(); it!=recs.end(); ++it)
+  { const profile::phase_record& rec = it->second;
+    own_row counters = std::make_shared<row_value>(0);
+    counters->val.reserve(rec.counters.size());
+    for (auto c=rec.counters.begin(); c!=rec.counters.end(); ++c)
+    { own_tuple pair = std::make_shared<tuple_value>(2);
+      pair->val[0] = std::make_shared<string_value>(c->first);
+      pair->val[1] = std::make_shared<int_value>
+        (big_int::from_unsigned(c->second));
+      counters->val.push_back(pair);
+    }
+    own_tuple entry = std::make_shared<tuple_value>(6);
+    entry->val[0] = std::make_shared<string_value>(it->first);
+    entry->val[1] = std::make_shared<int_value>
+      (big_int::from_unsigned(rec.calls));
+    entry->val[2] = std::make_shared<int_value>
+      (big_int::from_unsigned
+        (static_cast<unsigned long long>(rec.seconds*1e6)));
+    entry->val[3] = std::make_shared<int_value>
+      (big_int::from_unsigned(rec.max_resident_kB));
+    entry->val[4] = std::make_shared<int_value>(big_int(rec.heap_growth));
+    entry->val[5] = counters;
+    result->val.push_back(entry);
+  }
+  push_value(result);
+}
+@)
+void profile_json_wrapper(expression_base::level l)
+{ if (l==expression_base::no_value)
+    return;
+  std::ostringstream s; profile::write_json(s);
+  push_value(std::make_shared<string_value>(s.str()));
+}
+@)
+void reset_profile_wrapper(expression_base::level l)
+{ profile::reset();
+  if (l==expression_base::single_value)
+    wrap_tuple<0>();
+}
+
+
 @ Here we install all remaining wrapper functions.
 
 @< Install wrapper functions @>=
@@ -5726,6 +5790,10 @@ install_function(print_KL_list_wrapper,@|"print_KL_list","(Block->)");
 install_function(print_W_cells_wrapper,@|"print_W_cells","(Block->)");
 install_function(W_cells_wrapper,@|"W_cells","(Block->[vec])");
 install_function(print_W_graph_wrapper,@|"print_W_graph","(Block->)");
+install_function(profile_data_wrapper,@|"profile_data"
+		,"(->[(string,int,int,int,int,[(string,int)])])");
+install_function(profile_json_wrapper,@|"profile_json","(->string)");
+install_function(reset_profile_wrapper,@|"reset_profile","(->)");
 
 @* Installing coercions.
 %
@@ -1223,13 +1223,14 @@ defined in the current module.
 
 This section can be seen as in introduction to the large
 module \.{atlas-types.w}, in which many more types and functions are
-defined that provide Atlas-specific functionality. In fact the type for
-rational numbers defined here is based on the |RatWeight| class defined in the
-Atlas library, so we must include a header file (which defines the necessary
-class template) into ours.
+defined that provide Atlas-specific functionality. In fact the types for
+integers and rational numbers defined here are based on the |big_int| and
+|big_rat| classes defined in the Atlas library, so we must include header files
+(which define the necessary classes) into ours.
 
 @<Includes needed in the header file @>=
 #include "arithmetic.h"
+#include "bigint.h"
 
 @*1 First primitive types: integer, rational, string and Boolean values.
 %
@@ -1242,16 +1243,23 @@ being pushed onto the execution stack) becomes available for sharing; for the
 types where this applies we also |typedef| a non-|const| instance of the
 |shared_ptr| template, using the \&{own\_} prefix.
 
+Integers and rational numbers are of unbounded size: they are held in the
+machine types as long as they fit, and in a multi-precision representation
+otherwise. Most library functions need \Cpp\ values, which the methods
+|int_val| and |rat_val| provide; they throw |std::overflow_error| for values
+that do not fit, which aborts evaluation with an error message.
+
 @< Type definitions @>=
 
 struct int_value : public value_base
-{ int val;
+{ big_int val;
 @)
-  explicit int_value(int v) : val(v) @+ {}
+  explicit int_value(big_int v) : val(std::move(v)) @+ {}
   ~int_value()@+ {}
   void print(std::ostream& out) const @+{@; out << val; }
   int_value* clone() const @+{@; return new int_value(*this); }
   static const char* name() @+{@; return "integer"; }
+  int int_val() const @+{@; return val.int_val(); } // throws if too large
 private:
   int_value(const int_value& v) : val(v.val) @+{}
 };
@@ -1260,13 +1268,14 @@ typedef std::shared_ptr<const int_value> shared_int;
 typedef std::shared_ptr<int_value> own_int;
 @)
 struct rat_value : public value_base
-{ Rational val;
+{ big_rat val;
 @)
-  explicit rat_value(Rational v) : val(v) @+ {}
+  explicit rat_value(big_rat v) : val(std::move(v)) @+ {}
   ~rat_value()@+ {}
   void print(std::ostream& out) const @+{@; out << val; }
   rat_value* clone() const @+{@; return new rat_value(*this); }
   static const char* name() @+{@; return "integer"; }
+  Rational rat_val() const @+{@; return val.rat_val(); } // throws if too large
 private:
   rat_value(const rat_value& v) : val(v.val) @+{}
 };
@@ -1494,9 +1503,7 @@ vectors.
 
 @< Local function def... @>=
 void rational_convert() // convert integer to rational (with denominator~1)
-{@; int i = get<int_value>()->val;
-    push_value(std::make_shared<rat_value>(Rational(i)));
-}
+{@; push_value(std::make_shared<rat_value>(big_rat(get<int_value>()->val))); }
 @)
 void ratlist_ratvec_convert() // convert list of rationals to rational vector
 { shared_row r = get<row_value>();
@@ -1504,7 +1511,7 @@ void ratlist_ratvec_convert() // convert list of rationals to rational vector
   unsigned int d=1;
   for (size_t i=0; i<r->val.size(); ++i)
   // collect numerators and denominators separately
-  { Rational frac = force<rat_value>(r->val[i].get())->val;
+  { Rational frac = force<rat_value>(r->val[i].get())->rat_val();
     numer[i]=frac.numerator();
     denom[i]=frac.denominator();
     d=arithmetic::lcm(d,denom[i]); // and compute the least common denominator
@@ -1554,7 +1561,7 @@ of idiom was first applied within the Atlas software.
 int_Vector row_to_weight(const row_value& r)
 { int_Vector result(r.val.size());
   for(size_t i=0; i<r.val.size(); ++i)
-    result[i]=force<int_value>(r.val[i].get())->val;
+    result[i]=force<int_value>(r.val[i].get())->int_val();
   return result;
 }
 @)
@@ -1727,46 +1734,50 @@ Since arguments to built-in functions are evaluated with |level| parameter
 |multi_value|, two separate values will be present on the stack. Note that
 these are pulled from the stack in reverse order, which is important for the
 non-commutative operations like `|-|' and `|/|'. Since values are shared, we
-must allocate new value objects for the results.
+must allocate new value objects for the results. The |big_int| operations
+never overflow: results that do not fit in a machine word are simply
+represented in multi-precision form.
 
 @< Local function definitions @>=
 
 void plus_wrapper(expression_base::level l)
-{ int j=get<int_value>()->val; int i=get<int_value>()->val;
+{ shared_int j=get<int_value>(); shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<int_value>(i+j));
+    push_value(std::make_shared<int_value>(i->val+j->val));
 }
 @)
 void minus_wrapper(expression_base::level l)
-{ int j=get<int_value>()->val; int i=get<int_value>()->val;
+{ shared_int j=get<int_value>(); shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<int_value>(i-j));
+    push_value(std::make_shared<int_value>(i->val-j->val));
 }
 @)
 void times_wrapper(expression_base::level l)
-{ int j=get<int_value>()->val; int i=get<int_value>()->val;
+{ shared_int j=get<int_value>(); shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<int_value>(i*j));
+    push_value(std::make_shared<int_value>(i->val*j->val));
 }
 
 @ Euclidean division operation will be bound to the operator ``$\backslash$'',
 because ``$/$'' is used to form rational numbers. We take the occasion of
 defining a division operation to repair the integer division operation
 |operator/| built into \Cpp, which is traditionally broken for negative
-dividends. This is done by using |arithmetic::divide| that handles such cases
+dividends. This is done by using |big_int::div_mod| that handles such cases
 correctly (rounding the quotient systematically downwards). Since
-|arithmetic::divide| takes an unsigned second argument, we handle the case of
-a negative divisor ourselves. We do so by stipulating $a\backslash(-b)$ as
+|big_int::div_mod| requires a positive divisor, we handle the case of a
+negative divisor ourselves. We do so by stipulating $a\backslash(-b)$ as
 $-(a\backslash b)$. (Another option is to define $a\backslash(-b)$ as
 $(-a)\backslash b$; the jury is still out on which one is preferable.)
 
 @< Local function definitions @>=
 void divide_wrapper(expression_base::level l)
-{ int j=get<int_value>()->val; int i=get<int_value>()->val;
-  if (j==0) throw runtime_error("Division by zero");
+{ shared_int j=get<int_value>(); shared_int i=get<int_value>();
+  if (j->val.is_zero()) throw runtime_error("Division by zero");
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<int_value>
-     (j>0 ? arithmetic::divide(i,j) : -arithmetic::divide(i,-j)));
+  { big_int r;
+    push_value(std::make_shared<int_value>(j->val.is_positive()
+      ? i->val.div_mod(j->val,r) : -i->val.div_mod(-j->val,r)));
+  }
 }
 
 @ We also define a remainder operation |modulo|, a combined
@@ -1775,133 +1786,126 @@ power operation (defined whenever the result is integer).
 
 @< Local function definitions @>=
 void modulo_wrapper(expression_base::level l)
-{ int  j=get<int_value>()->val; int i=get<int_value>()->val;
-  if (j==0) throw runtime_error("Modulo zero");
+{ shared_int j=get<int_value>(); shared_int i=get<int_value>();
+  if (j->val.is_zero()) throw runtime_error("Modulo zero");
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<int_value>
-      (arithmetic::remainder(i,std::abs(j))));
+  { big_int r;
+    i->val.div_mod(j->val.is_positive() ? j->val : -j->val,r);
+    push_value(std::make_shared<int_value>(std::move(r)));
+  }
 }
 @)
 void divmod_wrapper(expression_base::level l)
-{ int j=get<int_value>()->val; int i=get<int_value>()->val;
-  if (j==0) throw runtime_error("DivMod by zero");
+{ shared_int j=get<int_value>(); shared_int i=get<int_value>();
+  if (j->val.is_zero()) throw runtime_error("DivMod by zero");
   if (l!=expression_base::no_value)
-  { push_value(std::make_shared<int_value>
-     (j>0 ? arithmetic::divide(i,j) : -arithmetic::divide(i,-j)));
-    push_value(std::make_shared<int_value>
-      (arithmetic::remainder(i,std::abs(j))));
+  { big_int r;
+    push_value(std::make_shared<int_value>(j->val.is_positive()
+      ? i->val.div_mod(j->val,r) : -i->val.div_mod(-j->val,r)));
+    push_value(std::make_shared<int_value>(std::move(r)));
     if (l==expression_base::single_value)
       wrap_tuple<2>();
   }
 }
 @)
 void unary_minus_wrapper(expression_base::level l)
-{ int i=get<int_value>()->val;
+{ shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<int_value>(-i));
+    push_value(std::make_shared<int_value>(-i->val));
 }
 @)
 void power_wrapper(expression_base::level l)
 { static shared_int one = std::make_shared<int_value>(1);
   static shared_int minus_one  = std::make_shared<int_value>(-1);
-@/int n=get<int_value>()->val; int i=get<int_value>()->val;
-  if (std::abs(i)!=1 and n<0)
+@/int n=get<int_value>()->int_val(); shared_int i=get<int_value>();
+  const bool unit = i->val==big_int(1) or i->val==big_int(-1);
+  if (not unit and n<0)
     throw runtime_error("Negative power of integer");
   if (l==expression_base::no_value)
     return;
 @)
-  if (i==1)
-  {@; push_value(one);
+  if (unit)
+  {@; push_value(i->val.is_positive() or n%2==0 ? one : minus_one);
       return;
   }
-  if (i==-1)
-  {@; push_value(n%2==0 ? one : minus_one);
-      return;
-  }
-@)
-  push_value(std::make_shared<int_value>(arithmetic::power(i,n)));
+  push_value(std::make_shared<int_value>(i->val.power(n)));
 }
 
 @*1 Rationals.
 %
 As mentioned above the operator `/' applied to integers will not denote
-integer division, but rather formation of fractions (rational numbers). Since
-the |Rational| constructor requires an unsigned denominator, we must make sure
-the integer passed to it is positive. The opposite operation of separating a
-rational number into numerator and denominator is also provided; this
-operation is essential in order to be able to get from rationals back into the
-world of integers. Currently this splitting operation has an intrinsic danger,
-since the \Cpp-type |int| used in |int_value| is smaller than the types used
-for numerator and denominator of |Rational| values (which are |long long int|
-respectively |unsigned long long int|).
+integer division, but rather formation of fractions (rational numbers). The
+|big_rat| constructor takes care of making the denominator positive, and of
+normalising the fraction. The opposite operation of separating a rational
+number into numerator and denominator is also provided; this operation is
+essential in order to be able to get from rationals back into the world of
+integers.
 
 @< Local function definitions @>=
 
 void fraction_wrapper(expression_base::level l)
-{ int d=get<int_value>()->val; int n=get<int_value>()->val;
-  if (d==0) throw runtime_error("fraction with zero denominator");
-  if (d<0) {@; d=-d; n=-n; } // ensure denominator is positive
+{ shared_int d=get<int_value>(); shared_int n=get<int_value>();
+  if (d->val.is_zero()) throw runtime_error("fraction with zero denominator");
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<rat_value>(Rational(n,d)));
+    push_value(std::make_shared<rat_value>(big_rat(n->val,d->val)));
 }
 @)
 
 void unfraction_wrapper(expression_base::level l)
-{ Rational q=get<rat_value>()->val;
+{ shared_rat q=get<rat_value>();
   if (l!=expression_base::no_value)
-  { push_value(std::make_shared<int_value>(q.numerator()));
-    push_value(std::make_shared<int_value>(q.denominator()));
+  { push_value(std::make_shared<int_value>(q->val.numerator()));
+    push_value(std::make_shared<int_value>(q->val.denominator()));
     if (l==expression_base::single_value)
       wrap_tuple<2>();
   }
 }
 
-@ We define some arithmetic operations with a rational and integer operand,
-for efficiency.
+@ We define some arithmetic operations with a rational and integer operand.
 
 @< Local function definitions @>=
 void rat_plus_int_wrapper(expression_base::level l)
-{ int i=get<int_value>()->val;
+{ shared_int i=get<int_value>();
   own_rat q=get_own<rat_value>();
   if (l==expression_base::no_value)
     return;
-  q->val+=i;
+  q->val=q->val+big_rat(i->val);
   push_value(q);
 }
 void rat_minus_int_wrapper(expression_base::level l)
-{ int i=get<int_value>()->val;
+{ shared_int i=get<int_value>();
   own_rat q=get_own<rat_value>();
   if (l==expression_base::no_value)
     return;
-  q->val-=i;
+  q->val=q->val-big_rat(i->val);
   push_value(q);
 }
 void rat_times_int_wrapper(expression_base::level l)
-{ int i=get<int_value>()->val;
+{ shared_int i=get<int_value>();
   own_rat q=get_own<rat_value>();
   if (l==expression_base::no_value)
     return;
-  q->val*=i;
+  q->val=q->val*big_rat(i->val);
   push_value(q);
 }
 void rat_divide_int_wrapper(expression_base::level l)
-{ int i=get<int_value>()->val;
+{ shared_int i=get<int_value>();
   own_rat q=get_own<rat_value>();
-  if (i==0)
+  if (i->val.is_zero())
     throw runtime_error("Rational division by zero");
   if (l==expression_base::no_value)
     return;
-  q->val/=i;
+  q->val=q->val/big_rat(i->val);
   push_value(q);
 }
 void rat_modulo_int_wrapper(expression_base::level l)
-{ int i=get<int_value>()->val;
+{ shared_int i=get<int_value>();
   own_rat q=get_own<rat_value>();
-  if (i==0)
+  if (i->val.is_zero())
     throw runtime_error("Rational modulo zero");
   if (l==expression_base::no_value)
     return;
-  q->val%=i;
+  q->val=q->val%big_rat(i->val);
   push_value(q);
 }
 
@@ -1911,60 +1915,60 @@ operator overloading.
 @< Local function definitions @>=
 
 void rat_plus_wrapper(expression_base::level l)
-{ Rational j=get<rat_value>()->val;
-  Rational i=get<rat_value>()->val;
+{ shared_rat j=get<rat_value>();
+  shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<rat_value>(i+j));
+    push_value(std::make_shared<rat_value>(i->val+j->val));
 }
 void rat_minus_wrapper(expression_base::level l)
-{ Rational j=get<rat_value>()->val;
-  Rational i=get<rat_value>()->val;
+{ shared_rat j=get<rat_value>();
+  shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<rat_value>(i-j));
+    push_value(std::make_shared<rat_value>(i->val-j->val));
 }
 @)
 void rat_times_wrapper(expression_base::level l)
-{ Rational j=get<rat_value>()->val;
-  Rational i=get<rat_value>()->val;
+{ shared_rat j=get<rat_value>();
+  shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<rat_value>(i*j));
+    push_value(std::make_shared<rat_value>(i->val*j->val));
 }
 @)
 void rat_divide_wrapper(expression_base::level l)
-{ Rational j=get<rat_value>()->val;
-  Rational i=get<rat_value>()->val;
-  if (j.numerator()==0)
+{ shared_rat j=get<rat_value>();
+  shared_rat i=get<rat_value>();
+  if (j->val.is_zero())
     throw runtime_error("Rational division by zero");
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<rat_value>(i/j));
+    push_value(std::make_shared<rat_value>(i->val/j->val));
 }
 void rat_modulo_wrapper(expression_base::level l)
-{ Rational j=get<rat_value>()->val;
-  Rational i=get<rat_value>()->val;
-  if (j.numerator()==0)
+{ shared_rat j=get<rat_value>();
+  shared_rat i=get<rat_value>();
+  if (j->val.is_zero())
     throw runtime_error("Rational modulo zero");
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<rat_value>(i%j));
+    push_value(std::make_shared<rat_value>(i->val%j->val));
 }
 @)
 void rat_unary_minus_wrapper(expression_base::level l)
-{@; Rational i=get<rat_value>()->val;
+{@; shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<rat_value>(Rational(0)-i)); }
+    push_value(std::make_shared<rat_value>(-i->val)); }
 @)
 void rat_inverse_wrapper(expression_base::level l)
-{@; Rational i=get<rat_value>()->val;
-  if (i.numerator()==0)
+{@; shared_rat i=get<rat_value>();
+  if (i->val.is_zero())
     throw runtime_error("Inverse of zero");
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<rat_value>(Rational(1)/i)); }
+    push_value(std::make_shared<rat_value>(i->val.inverse())); }
 @)
 void rat_power_wrapper(expression_base::level l)
-{ int n=get<int_value>()->val; Rational b=get<rat_value>()->val;
-  if (b.numerator()==0 and n<0)
+{ int n=get<int_value>()->int_val(); shared_rat b=get<rat_value>();
+  if (b->val.is_zero() and n<0)
     throw runtime_error("Negative power of zero");
   if (l!=expression_base::no_value)
-    push_value(std::make_shared<rat_value>(b.power(n)));
+    push_value(std::make_shared<rat_value>(b->val.power(n)));
 }
 
 @*1 Booleans.
@@ -1977,34 +1981,34 @@ avoids having to laboriously construct a null value of the correct dimension.
 @< Local function definitions @>=
 
 void int_unary_eq_wrapper(expression_base::level l)
-{ int i=get<int_value>()->val;
+{ shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i==0));
+    push_value(whether(i->val.is_zero()));
 }
 void int_unary_neq_wrapper(expression_base::level l)
-{ int i=get<int_value>()->val;
+{ shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i!=0));
+    push_value(whether(not i->val.is_zero()));
 }
 void int_non_negative_wrapper(expression_base::level l)
-{ int i=get<int_value>()->val;
+{ shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i>=0));
+    push_value(whether(not i->val.is_negative()));
 }
 void int_positive_wrapper(expression_base::level l)
-{ int i=get<int_value>()->val;
+{ shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i>0));
+    push_value(whether(i->val.is_positive()));
 }
 void int_non_positive_wrapper(expression_base::level l)
-{ int i=get<int_value>()->val;
+{ shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i<=0));
+    push_value(whether(not i->val.is_positive()));
 }
 void int_negative_wrapper(expression_base::level l)
-{ int i=get<int_value>()->val;
+{ shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i<0));
+    push_value(whether(i->val.is_negative()));
 }
 
 @ Here are the traditional, binary, versions of the relations.
@@ -2012,39 +2016,39 @@ void int_negative_wrapper(expression_base::level l)
 @< Local function definitions @>=
 
 void int_eq_wrapper(expression_base::level l)
-{ int j=get<int_value>()->val; int i=get<int_value>()->val;
+{ shared_int j=get<int_value>(); shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i==j));
+    push_value(whether(i->val==j->val));
 }
 @)
 void int_neq_wrapper(expression_base::level l)
-{ int j=get<int_value>()->val; int i=get<int_value>()->val;
+{ shared_int j=get<int_value>(); shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i!=j));
+    push_value(whether(i->val!=j->val));
 }
 @)
 void int_less_wrapper(expression_base::level l)
-{ int j=get<int_value>()->val; int i=get<int_value>()->val;
+{ shared_int j=get<int_value>(); shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i<j));
+    push_value(whether(i->val<j->val));
 }
 @)
 void int_lesseq_wrapper(expression_base::level l)
-{ int j=get<int_value>()->val; int i=get<int_value>()->val;
+{ shared_int j=get<int_value>(); shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i<=j));
+    push_value(whether(i->val<=j->val));
 }
 @)
 void int_greater_wrapper(expression_base::level l)
-{ int j=get<int_value>()->val; int i=get<int_value>()->val;
+{ shared_int j=get<int_value>(); shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i>j));
+    push_value(whether(i->val>j->val));
 }
 @)
 void int_greatereq_wrapper(expression_base::level l)
-{ int j=get<int_value>()->val; int i=get<int_value>()->val;
+{ shared_int j=get<int_value>(); shared_int i=get<int_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i>=j));
+    push_value(whether(i->val>=j->val));
 }
 
 @ For the rational numbers as well we define unary relations.
@@ -2052,34 +2056,34 @@ void int_greatereq_wrapper(expression_base::level l)
 @< Local function definitions @>=
 
 void rat_unary_eq_wrapper(expression_base::level l)
-{ Rational i=get<rat_value>()->val;
+{ shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i.numerator()==0));
+    push_value(whether(i->val.is_zero()));
 }
 void rat_unary_neq_wrapper(expression_base::level l)
-{ Rational i=get<rat_value>()->val;
+{ shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i.numerator()!=0));
+    push_value(whether(not i->val.is_zero()));
 }
 void rat_non_negative_wrapper(expression_base::level l)
-{ Rational i=get<rat_value>()->val;
+{ shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i.numerator()>=0));
+    push_value(whether(not i->val.is_negative()));
 }
 void rat_positive_wrapper(expression_base::level l)
-{ Rational i=get<rat_value>()->val;
+{ shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i.numerator()>0));
+    push_value(whether(i->val.is_positive()));
 }
 void rat_non_positive_wrapper(expression_base::level l)
-{ Rational i=get<rat_value>()->val;
+{ shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i.numerator()<=0));
+    push_value(whether(not i->val.is_positive()));
 }
 void rat_negative_wrapper(expression_base::level l)
-{ Rational i=get<rat_value>()->val;
+{ shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i.numerator()<0));
+    push_value(whether(i->val.is_negative()));
 }
 
 @ Here are the traditional, binary, versions of the relations for the
@@ -2088,39 +2092,39 @@ rational numbers.
 @< Local function definitions @>=
 
 void rat_eq_wrapper(expression_base::level l)
-{ Rational j=get<rat_value>()->val; Rational i=get<rat_value>()->val;
+{ shared_rat j=get<rat_value>(); shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i==j));
+    push_value(whether(i->val==j->val));
 }
 @)
 void rat_neq_wrapper(expression_base::level l)
-{ Rational j=get<rat_value>()->val; Rational i=get<rat_value>()->val;
+{ shared_rat j=get<rat_value>(); shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i!=j));
+    push_value(whether(i->val!=j->val));
 }
 @)
 void rat_less_wrapper(expression_base::level l)
-{ Rational j=get<rat_value>()->val; Rational i=get<rat_value>()->val;
+{ shared_rat j=get<rat_value>(); shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i<j));
+    push_value(whether(i->val<j->val));
 }
 @)
 void rat_lesseq_wrapper(expression_base::level l)
-{ Rational j=get<rat_value>()->val; Rational i=get<rat_value>()->val;
+{ shared_rat j=get<rat_value>(); shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i<=j));
+    push_value(whether(i->val<=j->val));
 }
 @)
 void rat_greater_wrapper(expression_base::level l)
-{ Rational j=get<rat_value>()->val; Rational i=get<rat_value>()->val;
+{ shared_rat j=get<rat_value>(); shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i>j));
+    push_value(whether(i->val>j->val));
 }
 @)
 void rat_greatereq_wrapper(expression_base::level l)
-{ Rational j=get<rat_value>()->val; Rational i=get<rat_value>()->val;
+{ shared_rat j=get<rat_value>(); shared_rat i=get<rat_value>();
   if (l!=expression_base::no_value)
-    push_value(whether(i>=j));
+    push_value(whether(i->val>=j->val));
 }
 
 @ For booleans we also have equality and ineqality.
@@ -2189,7 +2193,7 @@ void string_geq_wrapper(expression_base::level l)
 }
 @)
 void int_format_wrapper(expression_base::level l)
-{ int n=get<int_value>()->val;
+{ int n=get<int_value>()->int_val();
   std::ostringstream o; o<<n;
   if (l!=expression_base::no_value)
     push_value(std::make_shared<string_value>(o.str()));
@@ -2236,7 +2240,7 @@ void string_to_ascii_wrapper(expression_base::level l)
 }
 @)
 void ascii_char_wrapper(expression_base::level l)
-{ int c=get<int_value>()->val;
+{ int c=get<int_value>()->int_val();
   if ((c<' ' and c!='\n') or c>'~')
     throw runtime_error("Value "+str(c)+" out of range");
   if (l!=expression_base::no_value)
@@ -2308,7 +2312,7 @@ void matrix_bounds_wrapper(expression_base::level l)
 
 @< Local function definitions @>=
 void vector_suffix_wrapper(expression_base::level l)
-{ int e=get<int_value>()->val;
+{ int e=get<int_value>()->int_val();
   own_vector r=get_own<vector_value>();
   if (l!=expression_base::no_value)
   {@; r->val.push_back(e);
@@ -2318,7 +2322,7 @@ void vector_suffix_wrapper(expression_base::level l)
 @)
 void vector_prefix_wrapper(expression_base::level l)
 { own_vector r=get_own<vector_value>();
-  int e=get<int_value>()->val;
+  int e=get<int_value>()->int_val();
   if (l!=expression_base::no_value)
   {@; r->val.insert(r->val.begin(),e);
     push_value(r);
@@ -2557,7 +2561,7 @@ void vec_unary_minus_wrapper(expression_base::level l)
 }
 @)
 void vec_times_int_wrapper(expression_base::level l)
-{ int i= get<int_value>()->val;
+{ int i= get<int_value>()->int_val();
   own_vector v= get_own<vector_value>();
   if (l==expression_base::no_value)
     return;
@@ -2565,7 +2569,7 @@ void vec_times_int_wrapper(expression_base::level l)
   push_value(std::move(v));
 }
 void vec_divide_int_wrapper(expression_base::level l)
-{ int i= get<int_value>()->val;
+{ int i= get<int_value>()->int_val();
   own_vector v= get_own<vector_value>();
   if (i==0)
     throw runtime_error("Vector division by 0");
@@ -2575,7 +2579,7 @@ void vec_divide_int_wrapper(expression_base::level l)
   push_value(std::move(v));
 }
 void vec_modulo_int_wrapper(expression_base::level l)
-{ int i= get<int_value>()->val;
+{ int i= get<int_value>()->int_val();
   own_vector v= get_own<vector_value>();
   if (i==0)
     throw runtime_error("Vector modulo 0");
@@ -2756,7 +2760,7 @@ also provide addition and subtraction of another rational vector.
 
 @< Local function def... @>=
 void vector_div_wrapper(expression_base::level l)
-{ int n=get<int_value>()->val;
+{ int n=get<int_value>()->int_val();
   own_vector v=get_own<vector_value>();
   if (l!=expression_base::no_value)
     push_value@|(std::make_shared<rational_vector_value>
@@ -2802,7 +2806,7 @@ lead to a smaller denominator since it effectively adds an integer vector.
 
 @< Local function def... @>=
 void ratvec_times_int_wrapper(expression_base::level l)
-{ int i= get<int_value>()->val;
+{ int i= get<int_value>()->int_val();
   own_rational_vector v= get_own<rational_vector_value>();
   if (l==expression_base::no_value)
     return;
@@ -2810,7 +2814,7 @@ void ratvec_times_int_wrapper(expression_base::level l)
   push_value(v);
 }
 void ratvec_divide_int_wrapper(expression_base::level l)
-{ int i= get<int_value>()->val;
+{ int i= get<int_value>()->int_val();
   own_rational_vector v= get_own<rational_vector_value>();
   if (i==0)
     throw runtime_error("Rational vector division by 0");
@@ -2820,7 +2824,7 @@ void ratvec_divide_int_wrapper(expression_base::level l)
   push_value(v);
 }
 void ratvec_modulo_int_wrapper(expression_base::level l)
-{ int i= get<int_value>()->val;
+{ int i= get<int_value>()->int_val();
   own_rational_vector v= get_own<rational_vector_value>();
   if (i==0)
     throw runtime_error("Rational vector modulo 0");
@@ -2832,7 +2836,7 @@ void ratvec_modulo_int_wrapper(expression_base::level l)
 @)
 
 void ratvec_times_rat_wrapper(expression_base::level l)
-{ Rational r= get<rat_value>()->val;
+{ Rational r= get<rat_value>()->rat_val();
   own_rational_vector v= get_own<rational_vector_value>();
   if (l==expression_base::no_value)
     return;
@@ -2840,7 +2844,7 @@ void ratvec_times_rat_wrapper(expression_base::level l)
   push_value(v);
 }
 void ratvec_divide_rat_wrapper(expression_base::level l)
-{ Rational r= get<rat_value>()->val;
+{ Rational r= get<rat_value>()->rat_val();
   own_rational_vector v= get_own<rational_vector_value>();
   if (r.numerator()==0)
     throw runtime_error("Rational vector division by 0");
@@ -2858,7 +2862,7 @@ matrices and integers.
 
 @< Local function definitions @>=
 void mat_plus_int_wrapper(expression_base::level l)
-{ int i= get<int_value>()->val;
+{ int i= get<int_value>()->int_val();
   own_matrix m= get_own<matrix_value>();
   if (l==expression_base::no_value)
     return;
@@ -2866,7 +2870,7 @@ void mat_plus_int_wrapper(expression_base::level l)
   push_value(m);
 }
 void mat_minus_int_wrapper(expression_base::level l)
-{ int i= get<int_value>()->val;
+{ int i= get<int_value>()->int_val();
   own_matrix m= get_own<matrix_value>();
   if (l==expression_base::no_value)
     return;
@@ -2876,7 +2880,7 @@ void mat_minus_int_wrapper(expression_base::level l)
 @)
 void int_plus_mat_wrapper(expression_base::level l)
 { own_matrix m= get_own<matrix_value>();
-  int i= get<int_value>()->val;
+  int i= get<int_value>()->int_val();
   if (l==expression_base::no_value)
     return;
   m->val += i;
@@ -2884,7 +2888,7 @@ void int_plus_mat_wrapper(expression_base::level l)
 }
 void int_minus_mat_wrapper(expression_base::level l)
 { own_matrix m= get_own<matrix_value>();
-  int i= get<int_value>()->val;
+  int i= get<int_value>()->int_val();
   if (l==expression_base::no_value)
     return;
   m->val.negate();
@@ -3132,15 +3136,15 @@ in fact be hard to avoid.
 
 @< Local function definitions @>=
 void null_vec_wrapper(expression_base::level l)
-{ int n=get<int_value>()->val;
+{ int n=get<int_value>()->int_val();
   if (n<0)
     throw runtime_error("Negative size for vector: "+str(n));
   if (l!=expression_base::no_value)
     push_value(std::make_shared<vector_value>(int_Vector(n,0)));
 }
 @) void null_mat_wrapper(expression_base::level l)
-{ int n=get<int_value>()->val;
-  int m=get<int_value>()->val;
+{ int n=get<int_value>()->int_val();
+  int m=get<int_value>()->int_val();
   if (m<0)
     throw runtime_error("Negative number of rows: "+str(m));
   if (n<0)
@@ -3176,7 +3180,7 @@ to do the work.
 }
 @)
 void id_mat_wrapper(expression_base::level l)
-{ int i=get<int_value>()->val;
+{ int i=get<int_value>()->int_val();
   if (l!=expression_base::no_value)
     push_value(std::make_shared<matrix_value>
       (int_Matrix(std::max(i,0)))); // identity
@@ -3234,7 +3238,7 @@ providing a desired number of rows.
 @< Local function def... @>=
 void combine_columns_wrapper(expression_base::level l)
 { shared_row r = get<row_value>();
-  int n = get<int_value>()->val;
+  int n = get<int_value>()->int_val();
   if (n<0)
     throw runtime_error("Negative number "+str(n)+" of rows requested");
 @.Negative number of rows@>
@@ -3253,7 +3257,7 @@ void combine_columns_wrapper(expression_base::level l)
 @)
 void combine_rows_wrapper(expression_base::level l)
 { shared_row r =get<row_value>();
-  int n = get<int_value>()->val;
+  int n = get<int_value>()->int_val();
   if (n<0)
     throw runtime_error("Negative number "+str(n)+" of columns requested");
 @.Negative number of columns@>
@@ -3318,13 +3322,13 @@ transposition and bit~$7$ negation of the individual entries.
 @< Local function def... @>=
 
 void swiss_matrix_knife_wrapper(expression_base::level lev)
-{ int l = get<int_value>()->val;
-  int j = get<int_value>()->val;
-  int k = get<int_value>()->val;
-  int i = get<int_value>()->val;
+{ int l = get<int_value>()->int_val();
+  int j = get<int_value>()->int_val();
+  int k = get<int_value>()->int_val();
+  int i = get<int_value>()->int_val();
   shared_matrix src = get<matrix_value>();
   const int_Matrix& A = src->val;
-  BitSet<8> flags (get<int_value>()->val);
+  BitSet<8> flags (get<int_value>()->int_val());
 @)
   int m = A.numRows(); int n= A.numColumns();
   int lwb_r = flags[1] ? m-i : i;
@@ -3481,7 +3485,7 @@ void kernel_wrapper(expression_base::level l)
 }
 @)
 void eigen_lattice_wrapper(expression_base::level l)
-{ int eigen_value = get<int_value>()->val;
+{ int eigen_value = get<int_value>()->int_val();
   shared_matrix M=get<matrix_value>();
   if (l!=expression_base::no_value)
     push_value(std::make_shared<matrix_value>
@@ -3544,9 +3548,9 @@ void invert_wrapper(expression_base::level l)
   }
   if (l==expression_base::no_value)
     return;
-  own_int denom = std::make_shared<int_value>(0);
-@/push_value(std::make_shared<matrix_value>(m->val.inverse(denom->val)));
-  push_value(std::move(denom));
+  int denom;
+@/push_value(std::make_shared<matrix_value>(m->val.inverse(denom)));
+  push_value(std::make_shared<int_value>(denom));
   if (l==expression_base::single_value)
     wrap_tuple<2>();
 }
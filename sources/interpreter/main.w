@@ -355,17 +355,53 @@ const char* first_path = nullptr;
 options that set the search path for scripts, and a number of scripts that
 form the ``prelude''. The readline option must be read early to influence the
 constructor of the lexical analyser, but the other options are just stored
-away here for later processing.
+away here for later processing. Finally an option \.{--threads=}$n$ sets the
+number of threads that the Atlas library may use for computations that can be
+parallelised (with $n=0$ meaning as many as the hardware provides); since
+this only sets a global variable in the library, it is handled right away.
+The option \.{--rep-cache=}$d$ makes the tables of results for parameters kept
+per real form be saved in files in the directory~$d$, and be reloaded from
+them when a later session works with the same real form. Similarly \.{--kgb-cache=}$d$
+makes KGB sets, blocks and the involutions of Cartan classes be saved in files
+in the directory~$d$ once generated, and be read from there when they are
+needed again. The option \.{--block-memory=}$m$ sets the number of megabytes
+that the table kept for each real form may use for partial blocks it keeps in
+order to reuse them at translated parameters.
 
 @h <cstring>
+@h "parallel.h"
+@h "repr.h"
+@h "kgb.h"
 
 @< Handle command line arguments @>=
 while (*++argv!=nullptr)
 { static const char* const path_opt = "--path=";
   static const size_t pol = std::strlen(path_opt);
+  static const char* const threads_opt = "--threads=";
+  static const size_t tol = std::strlen(threads_opt);
+  static const char* const cache_opt = "--rep-cache=";
+  static const size_t cal = std::strlen(cache_opt);
+  static const char* const kgb_cache_opt = "--kgb-cache=";
+  static const size_t kcl = std::strlen(kgb_cache_opt);
+  static const char* const block_memory_opt = "--block-memory=";
+  static const size_t bml = std::strlen(block_memory_opt);
   std::string arg(*argv);
   if (arg=="--no-readline")
     {@; use_readline = false; continue; }
+  if (arg.substr(0,tol)==threads_opt)
+    {@; atlas::parallel::set_thread_count
+        (std::strtoul(&(*argv)[tol],nullptr,10));
+      continue;
+    }
+  if (arg.substr(0,cal)==cache_opt)
+    {@; atlas::repr::set_cache_directory(arg.substr(cal)); continue; }
+  if (arg.substr(0,kcl)==kgb_cache_opt)
+    {@; atlas::kgb::set_cache_directory(arg.substr(kcl)); continue; }
+  if (arg.substr(0,bml)==block_memory_opt)
+    {@; atlas::repr::set_block_cache_budget
+        (std::size_t(std::strtoul(&(*argv)[bml],nullptr,10))<<20);
+      continue;
+    }
   if (arg.substr(0,pol)==path_opt)
      paths.push_back(&(*argv)[pol]);
   else prelude_filenames.push_back(*argv);
@@ -119,6 +119,45 @@ namespace atlas {
       basic_io::put_int(magic_code,out);
     }
     
+    void matrix_stream::put_row(const kl::KLContext& klc, BlockElt y)
+    {
+      assert(y==row_start.size()); // rows must be passed in order
+      row_start.push_back(write_KL_row(klc,y,file));
+    }
+    
+    void matrix_stream::get_row(BlockElt y, kl::KLRow& row)
+    {
+      const std::streampos end=file.tellp(); // where writing should continue
+      file.seekg(row_start[y],std::ios_base::beg);
+    
+      const size_t n_prim=basic_io::read_bytes<4>(file);
+      std::vector<unsigned int> bits((n_prim+31)/32);
+      for (size_t i=0; i<bits.size(); ++i)
+        bits[i]=basic_io::read_bytes<4>(file);
+    
+      row.assign(n_prim-1,kl::KLIndex(0)); // the final entry for |y| is not recorded
+      for (size_t i=0; i<row.size(); ++i)
+        if ((bits[i/32]>>(i%32)&1)!=0)
+          row[i]=basic_io::read_bytes<4>(file);
+    
+      file.seekp(end);
+      if (not file.good()) throw error::InputError();
+    }
+    
+    void matrix_stream::finish()
+    {
+      std::streamoff offset=0;
+      for (BlockElt y=0; y<row_start.size(); ++y)
+      {
+        basic_io::put_int(static_cast<unsigned int>((row_start[y]-offset)/4),file);
+        offset=row_start[y];
+      }
+    
+      file.seekp(0,std::ios_base::beg);
+      basic_io::put_int(magic_code,file);
+      file.flush();
+    }
+    
     void write_KL_store(const kl::KLStore& store, std::ostream& out)
     {
       const size_t coef_size=4; // dictated (for now) by |basic_io::put_int|
@@ -4,8 +4,10 @@
 
 
 #include <iosfwd>
+#include <vector>
 
 #include "../Atlas.h"
+#include "kl.h" // for |kl::Row_sink|
 
 namespace atlas {
   namespace filekl {
@@ -20,6 +22,17 @@ namespace atlas {
     
     void write_matrix_file(const kl::KLContext& klc, std::ostream& out);
     
+    class matrix_stream : public kl::Row_sink
+    {
+      std::iostream& file; // non-owned reference to (open) file
+      std::vector<std::streamoff> row_start; // positions returned by |write_KL_row|
+    public:
+      explicit matrix_stream(std::iostream& file) : file(file), row_start() {}
+      virtual void put_row(const kl::KLContext& klc, BlockElt y);
+      virtual void get_row(BlockElt y, kl::KLRow& row);
+      void finish(); // write table of row positions, and sign the file
+    };
+    
     void write_KL_store(const kl::KLStore& store, std::ostream& out);
 
   }
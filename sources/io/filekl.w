@@ -68,14 +68,16 @@ namespace atlas {
 }@;
 #endif
 
-@ The header file \.{filekl.h} requires no include files other than the
-forward declarations contained in the \.{iosfwd} standard header
-and \.{Atlas.h}.
+@ The header file \.{filekl.h} requires, apart from the forward declarations
+contained in the \.{iosfwd} standard header and \.{Atlas.h}, the definition
+of the class |kl::Row_sink| from which |matrix_stream| derives.
 
 @< Includes needed in the header file @>=
 #include <iosfwd>
+#include <vector>
 
 #include "../Atlas.h"
+#include "kl.h" // for |kl::Row_sink|
 
 @
 @( filekl_in.cpp @>=
@@ -125,6 +127,8 @@ namespace atlas {
 @ The same includes are needed in both header files
 @< Includes needed in the input header file @>=
 #include <iosfwd>
+#include <string>
+#include <vector>
 
 #include "bitset.h"
 #include "../Atlas.h"
@@ -401,6 +405,74 @@ void write_matrix_file(const kl::KLContext& klc, std::ostream& out)
   basic_io::put_int(magic_code,out);
 }
 
+@ When the KL matrix is too large to be held in memory, its rows can instead
+be written as they are computed, by passing a |matrix_stream| to the method
+|kl::KLContext::stream_rows| before filling. Rows are written by
+|write_KL_row| as they arrive, and since the KL computation may need rows
+again after they were evicted from memory, the class can read them back from
+the file, which must therefore be opened both for output and for input. Once
+all rows are written, the method |finish| adds the table of row positions and
+the magic code, after which the file is the same as one written by
+|write_matrix_file|.
+
+@< Declarations of exported functions @>=
+class matrix_stream : public kl::Row_sink
+{
+  std::iostream& file; // non-owned reference to (open) file
+  std::vector<std::streamoff> row_start; // positions returned by |write_KL_row|
+public:
+  explicit matrix_stream(std::iostream& file) : file(file), row_start() @+{}
+  virtual void put_row(const kl::KLContext& klc, BlockElt y);
+  virtual void get_row(BlockElt y, kl::KLRow& row);
+  void finish(); // write table of row positions, and sign the file
+};
+
+@~Rows are read back by decoding the format written by |write_KL_row|: after
+the number of primitive elements (including |y| itself) comes a bitmap
+telling which of them have nonzero polynomials, followed by the indices of
+those polynomials. Reading moves the file position, which is shared with
+writing, so we restore it afterwards.
+
+@< Functions for writing binary files @>=
+void matrix_stream::put_row(const kl::KLContext& klc, BlockElt y)
+{
+  assert(y==row_start.size()); // rows must be passed in order
+  row_start.push_back(write_KL_row(klc,y,file));
+}
+
+void matrix_stream::get_row(BlockElt y, kl::KLRow& row)
+{
+  const std::streampos end=file.tellp(); // where writing should continue
+  file.seekg(row_start[y],std::ios_base::beg);
+
+  const size_t n_prim=basic_io::read_bytes<4>(file);
+  std::vector<unsigned int> bits((n_prim+31)/32);
+  for (size_t i=0; i<bits.size(); ++i)
+    bits[i]=basic_io::read_bytes<4>(file);
+
+  row.assign(n_prim-1,kl::KLIndex(0)); // the final entry for |y| is not recorded
+  for (size_t i=0; i<row.size(); ++i)
+    if ((bits[i/32]>>(i%32)&1)!=0)
+      row[i]=basic_io::read_bytes<4>(file);
+
+  file.seekp(end);
+  if (not file.good()) throw error::InputError();
+}
+
+void matrix_stream::finish()
+{
+  std::streamoff offset=0;
+  for (BlockElt y=0; y<row_start.size(); ++y)
+  {
+    basic_io::put_int(static_cast<unsigned int>((row_start[y]-offset)/4),file);
+    offset=row_start[y];
+  }
+
+  file.seekp(0,std::ios_base::beg);
+  basic_io::put_int(magic_code,file);
+  file.flush();
+}
+
 @*The {\bf matrix\_info} class.
 
 @< Includes needed in the input implementation file @>=
@@ -824,6 +896,401 @@ size_t cached_pol_info::leading_coeff (KLIndex i) const
   return lc;
 }
 
+@* Memory-mapped access to the binary files.
+The classes above read the files through |std::ifstream| objects, decoding
+data as they go, and |block_info| and |cached_pol_info| even read through the
+whole file on construction. For the very large files produced for the big
+block of~$E_8$ this makes starting up a utility program take minutes. The
+classes below instead map the files read-only into memory, and decode values
+directly from the mapped bytes when they are asked for; this makes
+construction nearly instantaneous, and allows several processes that consult
+the same files to share the pages of the operating system's file cache. They
+provide the same accessors as the corresponding stream based classes, so that
+client code can be written for either. They require the matrix file to be in
+the new format, which is the only one written nowadays.
+
+The class |mapped_file| owns the mapping of one file. All numbers in these
+files are stored in little-endian order, and |read| reassembles them from
+their bytes, which is independent of the byte order of the machine.
+
+@< Input class declarations @>=
+
+class mapped_file
+{
+  const unsigned char* base; // start of the read-only mapping of the file
+  ullong file_size;
+
+  mapped_file(const mapped_file&); // copying forbidden
+  mapped_file& operator=(const mapped_file&); // assignment forbidden
+public:
+  explicit mapped_file(const std::string& name); // maps the whole file
+  ~mapped_file();
+
+  ullong size() const @+{@; return file_size; }
+  ullong read(ullong offset, unsigned int n) const // |n| bytes at |offset|
+  {@; ullong result=0;
+    for (const unsigned char* p=base+offset+n; p!=base+offset; )
+      result=(result<<8)+*--p;
+    return result;
+  }
+};
+
+@ Opening the file is only needed to create the mapping, so the file
+descriptor is closed right away; the mapping remains valid until |munmap|.
+
+@< Includes needed in the input implementation file @>=
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+@~@< Methods for reading binary files @>=
+
+mapped_file::mapped_file(const std::string& name)
+: base(nullptr), file_size(0)
+{ int fd=open(name.c_str(),O_RDONLY);
+  if (fd<0)
+    throw std::runtime_error("Could not open file "+name);
+  struct stat status;
+  if (fstat(fd,&status)!=0)
+  {@; close(fd); throw std::runtime_error("Could not measure file "+name); }
+  file_size=status.st_size;
+  if (file_size>0) // |mmap| refuses to map empty files
+  { void* p=mmap(nullptr,file_size,PROT_READ,MAP_SHARED,fd,0);
+    if (p==MAP_FAILED)
+    {@; close(fd); throw std::runtime_error("Could not map file "+name); }
+    base=static_cast<const unsigned char*>(p);
+  }
+  close(fd);
+}
+
+mapped_file::~mapped_file()
+{@; if (base!=nullptr)
+    munmap(const_cast<unsigned char*>(base),file_size);
+}
+
+@ The class |mapped_block_info| gives the same information as |block_info|,
+but looks up descent sets and ascents in the mapped file. Only the lists of
+weakly primitive elements, which are not stored in the file, are computed
+(on demand, as before) and stored.
+
+@< Input class declarations @>=
+
+class mapped_block_info
+{
+  const mapped_file& file; // non-owned reference to the mapped block file
+  unsigned int d_rank;
+  BlockElt d_size;
+  unsigned int d_max_length; // maximal length of block elements
+  ullong descents_begin, ascents_begin; // offsets of tables in |file|
+  prim_table primitives_list; // lists of weakly primitives, per descent set
+
+public:
+  explicit mapped_block_info(const mapped_file& block_file);
+
+  unsigned int rank() const @+{@; return d_rank; }
+  BlockElt size() const @+{@; return d_size; }
+  unsigned int max_length() const @+{@; return d_max_length; }
+  BlockElt start_length(size_t l) const; // first element of length |l|
+  size_t length(BlockElt y) const; // length in block
+  RankFlags descent_set(BlockElt y) const
+    @+{@; return RankFlags(file.read(descents_begin+4*ullong(y),4)); }
+  BlockElt ascent(BlockElt x, size_t s) const
+    @+{@; return file.read(ascents_begin+4*(ullong(x)*d_rank+s),4); }
+
+  BlockElt primitivize(BlockElt x, BlockElt y) const;
+  const prim_list& prims_for_descents_of(BlockElt y);
+};
+
+@ The constructor only reads the header, and checks that the file size
+matches the sizes of the tables it announces.
+
+@< Methods for reading binary files @>=
+
+mapped_block_info::mapped_block_info(const mapped_file& block_file)
+: file(block_file), d_rank(), d_size(), d_max_length()
+, descents_begin(), ascents_begin(), primitives_list()
+{ if (file.size()<6)
+    throw std::runtime_error("Block file too short");
+  d_size=file.read(0,4);
+  d_rank=file.read(4,1);
+  d_max_length=file.read(5,1);
+  descents_begin=6+4*ullong(d_max_length);
+  ascents_begin=descents_begin+4*ullong(d_size);
+  if (file.size()!=ascents_begin+4*ullong(d_size)*d_rank)
+    throw std::runtime_error("Block file size does not match its contents");
+  primitives_list.resize(1ul<<d_rank); // create $2^{rank}$ empty vectors
+}
+
+@ The file records the first element of length~$l$ for $0<l\leq{}$|max_length|
+only; we supply the values for $l=0$ and $l=|max_length|+1$ ourselves.
+
+@< Methods for reading binary files @>=
+
+BlockElt mapped_block_info::start_length(size_t l) const
+{ return l==0 ? BlockElt(0)
+    : l>d_max_length ? d_size : BlockElt(file.read(6+4*(l-1),4));
+}
+
+size_t mapped_block_info::length(BlockElt y) const
+{ size_t low=0, high=d_max_length+1; // |y| has length in $[low,high)$
+  while (high-low>1)
+  {@; size_t mid=(low+high)/2;
+    if (start_length(mid)<=y)
+      low=mid;
+    else high=mid;
+  }
+  return low;
+}
+
+BlockElt mapped_block_info::primitivize(BlockElt x, BlockElt y) const
+{
+  RankFlags d=descent_set(y);
+start:
+  if (x>=y) return x; // possibly with |x==UndefBlock|
+  for (size_t s=0; s<d_rank; ++s)
+    if (d[s])
+    {@; BlockElt a=ascent(x,s);
+      if (a!=noGoodAscent)
+      @/{@; x=a; goto start; } // this should raise $x$, now try another step
+    }
+  return x; // no raising possible, stop here
+}
+
+const prim_list& mapped_block_info::prims_for_descents_of(BlockElt y)
+{ RankFlags d=descent_set(y);
+  prim_list& result=primitives_list[d.to_ulong()];
+  if (result.empty())
+  { for (BlockElt x=0; x<d_size; ++x)
+    {@; size_t s=0;
+      while (s<d_rank and not (d[s] and ascent(x,s)!=noGoodAscent))
+	++s;
+      if (s==d_rank) // then |x| is primitive for |d|
+	result.push_back(x);
+    }
+    prim_list(result).swap(result); // reallocate to fit snugly
+  }
+  return result;
+}
+
+@ The class |mapped_matrix_info| owns the mappings of the block and matrix
+files. At construction it only sums the relative row offsets stored at the end
+of the matrix file, 4 bytes per block element. Like |matrix_info| it keeps
+some information about the row~|cur_y| last looked into: here this is, for
+each 32-bit word of the bitmap of strongly primitive elements of the row, the
+number of bits set in preceding words. This allows |find_pol_nr| to locate
+the index of the polynomial directly in the mapped file.
+
+@< Input class declarations @>=
+
+class mapped_matrix_info
+{
+  mapped_file block_file, matrix_file; // owned mappings
+  mapped_block_info block;
+
+  std::vector<ullong> row_pos; // offsets where each row starts
+
+// data for currently selected row~|y|
+  BlockElt cur_y;
+  size_t cur_n_prim; // number of weakly primitives of smaller length, plus 1
+  ullong cur_bitmap, cur_entries; // offsets of bitmap and of indices
+  std::vector<unsigned int> cur_rank; // bits set in bitmap before each word
+
+//private methods
+  mapped_matrix_info(const mapped_matrix_info&); // copying forbidden
+  void set_y(BlockElt y);  // install |cur_y| and dependent data
+
+public:
+  BlockElt x_prim; // public variable that is set by |find_pol_nr|
+
+// constructor
+  mapped_matrix_info
+    (const std::string& block_file_name,const std::string& matrix_file_name);
+
+// accessors
+  size_t rank() const @+{@; return block.rank(); }
+  BlockElt block_size() const @+{@; return block.size(); }
+  size_t length (BlockElt y) const @+{@; return block.length(y); }
+  BlockElt first_of_length (size_t l) const
+    @+{@; return block.start_length(l); }
+  RankFlags descent_set (BlockElt y) const
+    @+{@; return block.descent_set(y); }
+  ullong row_offset(BlockElt y) const @+{@; return row_pos[y]; }
+  BlockElt primitivize (BlockElt x,BlockElt y) const
+    @+{@; return block.primitivize(x,y); }
+@/
+// manipulators (they are so because they set |cur_y|)
+  KLIndex find_pol_nr(BlockElt x,BlockElt y);
+  BlockElt prim_nr(unsigned int i,BlockElt y);
+  strong_prim_list strongly_primitives (BlockElt y); // a fresh list
+};
+
+@*1 Methods of the {\bf mapped\_matrix\_info} class.
+
+@< Methods for reading binary files @>=
+
+mapped_matrix_info::mapped_matrix_info
+  (const std::string& block_file_name,const std::string& matrix_file_name)
+: block_file(block_file_name), matrix_file(matrix_file_name)
+, block(block_file)
+, row_pos(block.size())
+, cur_y(UndefBlock), cur_n_prim(0), cur_bitmap(0), cur_entries(0), cur_rank()
+, x_prim(UndefBlock)
+{
+  const ullong trailer=4*ullong(block_size());
+  if (matrix_file.size()<4+trailer or matrix_file.read(0,4)!=magic_code)
+    throw std::runtime_error("Matrix file not in the new format");
+  ullong cumul=0;
+  for (BlockElt y=0; y<block_size(); ++y)
+  { cumul+= 4*matrix_file.read(matrix_file.size()-trailer+4*ullong(y),4);
+    row_pos[y] = cumul;
+  }
+  if (cumul>=matrix_file.size()-trailer)
+    throw std::runtime_error("Matrix file is corrupted");
+}
+
+@ The bitmap of row~|y| has a bit for each weakly primitive element for the
+descent set of~|y| of length less than that of~|y|, and a final bit standing
+for |y| itself; the bits set mark the strongly primitive ones, for which an
+index of a polynomial is recorded.
+
+@< Methods for reading binary files @>=
+
+void mapped_matrix_info::set_y(BlockElt y)
+{
+  if (y==cur_y)
+    return;
+  cur_y=y;
+  cur_n_prim=matrix_file.read(row_pos[y],4);
+  cur_bitmap=row_pos[y]+4;
+  const size_t n_words=(cur_n_prim+31)/32;
+  cur_entries=cur_bitmap+4*ullong(n_words);
+
+  cur_rank.resize(n_words);
+  unsigned int count=0;
+  for (size_t k=0; k<n_words; ++k)
+  {@; cur_rank[k]=count;
+    count+=bits::bitCount(matrix_file.read(cur_bitmap+4*k,4));
+  }
+}
+
+KLIndex mapped_matrix_info::find_pol_nr(BlockElt x,BlockElt y)
+{
+  x_prim=block.primitivize(x,y);
+  if (x_prim>=y)
+    return KLIndex(x_prim==y ? 1 : 0); // primitivisation copped out
+  const prim_list& weak_prims = block.prims_for_descents_of(y);
+  size_t i= // position of |x_prim| among weak primitives
+    std::lower_bound(weak_prims.begin(),weak_prims.end(),x_prim)
+    -weak_prims.begin();
+
+  set_y(y);
+  if (i+1>=cur_n_prim)
+    return KLIndex(0); // length of |x_prim| not less than that of |y|
+  unsigned int word=matrix_file.read(cur_bitmap+4*(i/32),4);
+  unsigned int bit=i%32;
+  if ((word>>bit&1)==0)
+    return KLIndex(0); // not strong
+
+  ullong nr=cur_rank[i/32]+bits::bitCount(word&((1u<<bit)-1));
+  return KLIndex(matrix_file.read(cur_entries+4*nr,4));
+}
+
+@
+@< Methods for reading binary files @>=
+
+BlockElt mapped_matrix_info::prim_nr(unsigned int i,BlockElt y)
+{ set_y(y);
+  size_t limit=cur_n_prim-1; // limiting value for |i|
+  if (i<limit) return block.prims_for_descents_of(y)[i];
+  else if (i==limit) return y;
+  std::cerr << "Limit is " << limit << ".\n";
+  throw std::runtime_error("Weakly primitive element index too large");
+}
+
+strong_prim_list mapped_matrix_info::strongly_primitives (BlockElt y)
+{
+  set_y(y);
+  const prim_list& weak_prims = block.prims_for_descents_of(y);
+  strong_prim_list result;
+  for (size_t i=0; i+1<cur_n_prim; i+=32)
+  {
+    unsigned int chunk=matrix_file.read(cur_bitmap+4*(i/32),4);
+    for (size_t j=0; chunk!=0 and i+j+1<cur_n_prim; ++j,chunk>>=1)
+      if ((chunk&1)!=0) result.push_back(weak_prims[i+j]);
+  }
+  result.push_back(y); // the final bit stands for |y| itself
+  return result;
+}
+
+@ Finally |mapped_polynomial_info| gives access to the polynomial file. Since
+the index of the starting position of the coefficients of each polynomial is
+stored directly in the file, the degree and leading coefficient are found
+without any work, so there is no need for a cached variant.
+
+@< Input class declarations @>=
+
+class mapped_polynomial_info
+{
+  mapped_file file; // owned mapping
+
+  KLIndex n_pols;         // number of polynomials in file
+  unsigned int coef_size; // number of bytes per coefficient
+  ullong n_coef;          // number of coefficients
+  ullong coefficients_begin; // offset of coefficients; indices start at 4
+
+  ullong index(KLIndex i) const // offset of coefficients of |i| from start
+    @+{@; return file.read(4+5*i,5); }
+public:
+  explicit mapped_polynomial_info(const std::string& file_name);
+
+  KLIndex n_polynomials() const @+{@; return n_pols; }
+  unsigned int coefficient_size() const @+{@; return coef_size; }
+  ullong n_coefficients() const @+{@; return n_coef; }
+
+  size_t degree(KLIndex i) const;
+  size_t coefficient(KLIndex i, size_t j) const // coefficient of $q^j$
+    @+{@; return file.read(coefficients_begin+index(i)+j*coef_size,coef_size); }
+  std::vector<size_t> coefficients(KLIndex i) const;
+  size_t leading_coeff(KLIndex i) const;
+  ullong coeff_start(KLIndex i) const // number of all preceding coefficients
+    @+{@; return index(i)/coef_size; }
+};
+
+@*1 Methods of the {\bf mapped\_polynomial\_info} class.
+
+@< Methods for reading binary files @>=
+
+mapped_polynomial_info::mapped_polynomial_info (const std::string& file_name)
+: file(file_name), n_pols(), coef_size(), n_coef(), coefficients_begin()
+{ if (file.size()<4+5*3)
+    throw std::runtime_error("Polynomial file too short");
+  n_pols=file.read(0,4);
+  coefficients_begin=4+5*(n_pols+1);
+  if (file.size()<coefficients_begin)
+    throw std::runtime_error("Polynomial file too short");
+  coef_size=index(2); // size of the |One|
+  if (coef_size==0 or file.size()!=coefficients_begin+index(n_pols))
+    throw std::runtime_error("Polynomial file size does not match contents");
+  n_coef=index(n_pols)/coef_size;
+}
+
+size_t mapped_polynomial_info::degree(KLIndex i) const
+{ if (i<2) return i-1; // quit exit for Zero and One
+  return (index(i+1)-index(i))/coef_size-1;
+}
+
+std::vector<size_t> mapped_polynomial_info::coefficients(KLIndex i) const
+{ std::vector<size_t> result((index(i+1)-index(i))/coef_size);
+  for (size_t j=0; j<result.size(); ++j)
+    result[j]=coefficient(i,j);
+  return result;
+}
+
+size_t mapped_polynomial_info::leading_coeff(KLIndex i) const
+{ if (i<2) return i; // this makes "leading coefficient" of Zero return 0
+  return file.read(coefficients_begin+index(i+1)-coef_size,coef_size);
+}
+
 @* The {\bf progress\_info} class.
 
 @< Input class declarations @>=
@@ -8,6 +8,11 @@
 
 #include "blocks.h"
 #include "bitset.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 namespace atlas {
   namespace filekl {
 
@@ -321,6 +326,205 @@ namespace atlas {
       return lc;
     }
     
+    mapped_file::mapped_file(const std::string& name)
+    : base(nullptr), file_size(0)
+    { int fd=open(name.c_str(),O_RDONLY);
+      if (fd<0)
+        throw std::runtime_error("Could not open file "+name);
+      struct stat status;
+      if (fstat(fd,&status)!=0)
+      { close(fd); throw std::runtime_error("Could not measure file "+name); }
+      file_size=status.st_size;
+      if (file_size>0) // |mmap| refuses to map empty files
+      { void* p=mmap(nullptr,file_size,PROT_READ,MAP_SHARED,fd,0);
+        if (p==MAP_FAILED)
+        { close(fd); throw std::runtime_error("Could not map file "+name); }
+        base=static_cast<const unsigned char*>(p);
+      }
+      close(fd);
+    }
+
+    mapped_file::~mapped_file()
+    { if (base!=nullptr)
+        munmap(const_cast<unsigned char*>(base),file_size);
+    }
+    
+    mapped_block_info::mapped_block_info(const mapped_file& block_file)
+    : file(block_file), d_rank(), d_size(), d_max_length()
+    , descents_begin(), ascents_begin(), primitives_list()
+    { if (file.size()<6)
+        throw std::runtime_error("Block file too short");
+      d_size=file.read(0,4);
+      d_rank=file.read(4,1);
+      d_max_length=file.read(5,1);
+      descents_begin=6+4*ullong(d_max_length);
+      ascents_begin=descents_begin+4*ullong(d_size);
+      if (file.size()!=ascents_begin+4*ullong(d_size)*d_rank)
+        throw std::runtime_error("Block file size does not match its contents");
+      primitives_list.resize(1ul<<d_rank); // create $2^{rank}$ empty vectors
+    }
+    
+    BlockElt mapped_block_info::start_length(size_t l) const
+    { return l==0 ? BlockElt(0)
+        : l>d_max_length ? d_size : BlockElt(file.read(6+4*(l-1),4));
+    }
+
+    size_t mapped_block_info::length(BlockElt y) const
+    { size_t low=0, high=d_max_length+1; // |y| has length in $[low,high)$
+      while (high-low>1)
+      { size_t mid=(low+high)/2;
+        if (start_length(mid)<=y)
+          low=mid;
+        else high=mid;
+      }
+      return low;
+    }
+
+    BlockElt mapped_block_info::primitivize(BlockElt x, BlockElt y) const
+    {
+      RankFlags d=descent_set(y);
+    start:
+      if (x>=y) return x; // possibly with |x==UndefBlock|
+      for (size_t s=0; s<d_rank; ++s)
+        if (d[s])
+        { BlockElt a=ascent(x,s);
+          if (a!=noGoodAscent)
+          { x=a; goto start; } // this should raise $x$, now try another step
+        }
+      return x; // no raising possible, stop here
+    }
+
+    const prim_list& mapped_block_info::prims_for_descents_of(BlockElt y)
+    { RankFlags d=descent_set(y);
+      prim_list& result=primitives_list[d.to_ulong()];
+      if (result.empty())
+      { for (BlockElt x=0; x<d_size; ++x)
+        { size_t s=0;
+          while (s<d_rank and not (d[s] and ascent(x,s)!=noGoodAscent))
+    	++s;
+          if (s==d_rank) // then |x| is primitive for |d|
+    	result.push_back(x);
+        }
+        prim_list(result).swap(result); // reallocate to fit snugly
+      }
+      return result;
+    }
+    
+    mapped_matrix_info::mapped_matrix_info
+      (const std::string& block_file_name,const std::string& matrix_file_name)
+    : block_file(block_file_name), matrix_file(matrix_file_name)
+    , block(block_file)
+    , row_pos(block.size())
+    , cur_y(UndefBlock), cur_n_prim(0), cur_bitmap(0), cur_entries(0), cur_rank()
+    , x_prim(UndefBlock)
+    {
+      const ullong trailer=4*ullong(block_size());
+      if (matrix_file.size()<4+trailer or matrix_file.read(0,4)!=magic_code)
+        throw std::runtime_error("Matrix file not in the new format");
+      ullong cumul=0;
+      for (BlockElt y=0; y<block_size(); ++y)
+      { cumul+= 4*matrix_file.read(matrix_file.size()-trailer+4*ullong(y),4);
+        row_pos[y] = cumul;
+      }
+      if (cumul>=matrix_file.size()-trailer)
+        throw std::runtime_error("Matrix file is corrupted");
+    }
+    
+    void mapped_matrix_info::set_y(BlockElt y)
+    {
+      if (y==cur_y)
+        return;
+      cur_y=y;
+      cur_n_prim=matrix_file.read(row_pos[y],4);
+      cur_bitmap=row_pos[y]+4;
+      const size_t n_words=(cur_n_prim+31)/32;
+      cur_entries=cur_bitmap+4*ullong(n_words);
+
+      cur_rank.resize(n_words);
+      unsigned int count=0;
+      for (size_t k=0; k<n_words; ++k)
+      { cur_rank[k]=count;
+        count+=bits::bitCount(matrix_file.read(cur_bitmap+4*k,4));
+      }
+    }
+
+    KLIndex mapped_matrix_info::find_pol_nr(BlockElt x,BlockElt y)
+    {
+      x_prim=block.primitivize(x,y);
+      if (x_prim>=y)
+        return KLIndex(x_prim==y ? 1 : 0); // primitivisation copped out
+      const prim_list& weak_prims = block.prims_for_descents_of(y);
+      size_t i= // position of |x_prim| among weak primitives
+        std::lower_bound(weak_prims.begin(),weak_prims.end(),x_prim)
+        -weak_prims.begin();
+
+      set_y(y);
+      if (i+1>=cur_n_prim)
+        return KLIndex(0); // length of |x_prim| not less than that of |y|
+      unsigned int word=matrix_file.read(cur_bitmap+4*(i/32),4);
+      unsigned int bit=i%32;
+      if ((word>>bit&1)==0)
+        return KLIndex(0); // not strong
+
+      ullong nr=cur_rank[i/32]+bits::bitCount(word&((1u<<bit)-1));
+      return KLIndex(matrix_file.read(cur_entries+4*nr,4));
+    }
+    
+    BlockElt mapped_matrix_info::prim_nr(unsigned int i,BlockElt y)
+    { set_y(y);
+      size_t limit=cur_n_prim-1; // limiting value for |i|
+      if (i<limit) return block.prims_for_descents_of(y)[i];
+      else if (i==limit) return y;
+      std::cerr << "Limit is " << limit << ".\n";
+      throw std::runtime_error("Weakly primitive element index too large");
+    }
+
+    strong_prim_list mapped_matrix_info::strongly_primitives (BlockElt y)
+    {
+      set_y(y);
+      const prim_list& weak_prims = block.prims_for_descents_of(y);
+      strong_prim_list result;
+      for (size_t i=0; i+1<cur_n_prim; i+=32)
+      {
+        unsigned int chunk=matrix_file.read(cur_bitmap+4*(i/32),4);
+        for (size_t j=0; chunk!=0 and i+j+1<cur_n_prim; ++j,chunk>>=1)
+          if ((chunk&1)!=0) result.push_back(weak_prims[i+j]);
+      }
+      result.push_back(y); // the final bit stands for |y| itself
+      return result;
+    }
+    
+    mapped_polynomial_info::mapped_polynomial_info (const std::string& file_name)
+    : file(file_name), n_pols(), coef_size(), n_coef(), coefficients_begin()
+    { if (file.size()<4+5*3)
+        throw std::runtime_error("Polynomial file too short");
+      n_pols=file.read(0,4);
+      coefficients_begin=4+5*(n_pols+1);
+      if (file.size()<coefficients_begin)
+        throw std::runtime_error("Polynomial file too short");
+      coef_size=index(2); // size of the |One|
+      if (coef_size==0 or file.size()!=coefficients_begin+index(n_pols))
+        throw std::runtime_error("Polynomial file size does not match contents");
+      n_coef=index(n_pols)/coef_size;
+    }
+
+    size_t mapped_polynomial_info::degree(KLIndex i) const
+    { if (i<2) return i-1; // quit exit for Zero and One
+      return (index(i+1)-index(i))/coef_size-1;
+    }
+
+    std::vector<size_t> mapped_polynomial_info::coefficients(KLIndex i) const
+    { std::vector<size_t> result((index(i+1)-index(i))/coef_size);
+      for (size_t j=0; j<result.size(); ++j)
+        result[j]=coefficient(i,j);
+      return result;
+    }
+
+    size_t mapped_polynomial_info::leading_coeff(KLIndex i) const
+    { if (i<2) return i; // this makes "leading coefficient" of Zero return 0
+      return file.read(coefficients_begin+index(i+1)-coef_size,coef_size);
+    }
+    
     progress_info::progress_info(std::ifstream& file)
     : first_pol()
     { file.seekg(0,std::ios_base::end); // measure |file|
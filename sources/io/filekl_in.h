@@ -5,6 +5,8 @@
 
 
 #include <iosfwd>
+#include <string>
+#include <vector>
 
 #include "bitset.h"
 #include "../Atlas.h"
@@ -131,6 +133,121 @@ namespace atlas {
       virtual size_t leading_coeff(KLIndex i) const;
     };
 
+    class mapped_file
+    {
+      const unsigned char* base; // start of the read-only mapping of the file
+      ullong file_size;
+
+      mapped_file(const mapped_file&); // copying forbidden
+      mapped_file& operator=(const mapped_file&); // assignment forbidden
+    public:
+      explicit mapped_file(const std::string& name); // maps the whole file
+      ~mapped_file();
+
+      ullong size() const { return file_size; }
+      ullong read(ullong offset, unsigned int n) const // |n| bytes at |offset|
+      { ullong result=0;
+        for (const unsigned char* p=base+offset+n; p!=base+offset; )
+          result=(result<<8)+*--p;
+        return result;
+      }
+    };
+
+    class mapped_block_info
+    {
+      const mapped_file& file; // non-owned reference to the mapped block file
+      unsigned int d_rank;
+      BlockElt d_size;
+      unsigned int d_max_length; // maximal length of block elements
+      ullong descents_begin, ascents_begin; // offsets of tables in |file|
+      prim_table primitives_list; // lists of weakly primitives, per descent set
+
+    public:
+      explicit mapped_block_info(const mapped_file& block_file);
+
+      unsigned int rank() const { return d_rank; }
+      BlockElt size() const { return d_size; }
+      unsigned int max_length() const { return d_max_length; }
+      BlockElt start_length(size_t l) const; // first element of length |l|
+      size_t length(BlockElt y) const; // length in block
+      RankFlags descent_set(BlockElt y) const
+        { return RankFlags(file.read(descents_begin+4*ullong(y),4)); }
+      BlockElt ascent(BlockElt x, size_t s) const
+        { return file.read(ascents_begin+4*(ullong(x)*d_rank+s),4); }
+
+      BlockElt primitivize(BlockElt x, BlockElt y) const;
+      const prim_list& prims_for_descents_of(BlockElt y);
+    };
+
+    class mapped_matrix_info
+    {
+      mapped_file block_file, matrix_file; // owned mappings
+      mapped_block_info block;
+
+      std::vector<ullong> row_pos; // offsets where each row starts
+
+    // data for currently selected row~|y|
+      BlockElt cur_y;
+      size_t cur_n_prim; // number of weakly primitives of smaller length, plus 1
+      ullong cur_bitmap, cur_entries; // offsets of bitmap and of indices
+      std::vector<unsigned int> cur_rank; // bits set in bitmap before each word
+
+    //private methods
+      mapped_matrix_info(const mapped_matrix_info&); // copying forbidden
+      void set_y(BlockElt y);  // install |cur_y| and dependent data
+
+    public:
+      BlockElt x_prim; // public variable that is set by |find_pol_nr|
+
+    // constructor
+      mapped_matrix_info
+        (const std::string& block_file_name,const std::string& matrix_file_name);
+
+    // accessors
+      size_t rank() const { return block.rank(); }
+      BlockElt block_size() const { return block.size(); }
+      size_t length (BlockElt y) const { return block.length(y); }
+      BlockElt first_of_length (size_t l) const
+        { return block.start_length(l); }
+      RankFlags descent_set (BlockElt y) const
+        { return block.descent_set(y); }
+      ullong row_offset(BlockElt y) const { return row_pos[y]; }
+      BlockElt primitivize (BlockElt x,BlockElt y) const
+        { return block.primitivize(x,y); }
+
+    // manipulators (they are so because they set |cur_y|)
+      KLIndex find_pol_nr(BlockElt x,BlockElt y);
+      BlockElt prim_nr(unsigned int i,BlockElt y);
+      strong_prim_list strongly_primitives (BlockElt y); // a fresh list
+    };
+
+    class mapped_polynomial_info
+    {
+      mapped_file file; // owned mapping
+
+      KLIndex n_pols;         // number of polynomials in file
+      unsigned int coef_size; // number of bytes per coefficient
+      ullong n_coef;          // number of coefficients
+      ullong coefficients_begin; // offset of coefficients; indices start at 4
+
+      ullong index(KLIndex i) const // offset of coefficients of |i| from start
+        { return file.read(4+5*i,5); }
+    public:
+      explicit mapped_polynomial_info(const std::string& file_name);
+
+      KLIndex n_polynomials() const { return n_pols; }
+      unsigned int coefficient_size() const { return coef_size; }
+      ullong n_coefficients() const { return n_coef; }
+
+      size_t degree(KLIndex i) const;
+      size_t coefficient(KLIndex i, size_t j) const // coefficient of $q^j$
+        { return file.read(coefficients_begin+index(i)+j*coef_size,coef_size); }
+      std::vector<size_t> coefficients(KLIndex i) const;
+      size_t leading_coeff(KLIndex i) const;
+      ullong coeff_start(KLIndex i) const // number of all preceding coefficients
+        { return index(i)/coef_size; }
+    };
+
     class progress_info
     {
       std::vector<KLIndex> first_pol; // count distinct polynomials in rows before
@@ -120,12 +120,14 @@ class OutputFile
 class InputFile {
  private:
   std::ifstream* d_stream;
+  std::string d_name;
  public:
   InputFile(std::string prompt,
             std::ios_base::openmode mode
 	      =std::ios_base::in | std::ios_base::binary);
   ~InputFile();
   operator std::ifstream& () {return *d_stream;}
+  const std::string& name() const {return d_name;} // of the file opened
 };
 
 }
@@ -60,7 +60,7 @@ std::ostream& printAllKL
     bool first = true;
 
     for (size_t x = 0; x <= y; ++x) {
-      const kl::KLPol& pol = klc.klPol(x,y);
+      const kl::KLPolRef pol = klc.klPol(x,y);
       if (pol.isZero())
 	continue;
       if (first)
@@ -105,8 +105,7 @@ std::ostream& printPrimitiveKL
   int width = ioutils::digits(klc.size()-1,10ul);
   int tab = 2;
 
-  BruhatOrder& bo=block.bruhatOrder(); // non-const!
-  const poset::Poset& Bruhat=bo.poset(); // full poset is generated here
+  BruhatOrder& Bruhat=block.bruhatOrder(); // non-const!
 
   for (size_t y = 0; y < klc.size(); ++y)
   {
@@ -165,7 +164,7 @@ std::ostream& printKLList(std::ostream& strm, const kl::KLContext& klc)
   // get polynomials, omitting Zero
   for (kl::KLIndex i=0; i<store.size(); ++i)
   {
-    const kl::KLPol& r=store[i];
+    const kl::KLPolRef r=store[i];
     if (not r.isZero()) polList.push_back(r);
   }
 
@@ -8,6 +8,8 @@
 */
 
 #include <iostream>
+#include <fstream>
+#include <algorithm> // |std::sort|
 
 #include "involutions.h"
 
@@ -20,7 +22,9 @@
 #include "innerclass.h"
 #include "lattice.h"
 
-#include "kgb.h" // for |KGB_elt_entry|
+#include "kgb.h" // for |KGB_elt_entry|, cache files
+#include "profile.h"
+#include "basic_io.h" // for binary cache files
 
 namespace atlas {
 
@@ -39,6 +43,15 @@ InvolutionData::InvolutionData(const RootDatum& rd,
 { classify_roots(rd); }
 
 void InvolutionData::classify_roots(const RootSystem& rs)
+{
+  sort_roots(rs);
+
+  // find simple-imaginary roots
+  d_simpleImaginary=rs.simpleBasis(imaginary_roots());
+  d_simpleReal=rs.simpleBasis(real_roots());
+}
+
+void InvolutionData::sort_roots(const RootSystem& rs)
 {
   for (RootNbr alpha = 0; alpha<rs.numRoots(); ++alpha)
     if (d_rootInvolution[alpha] == alpha)
@@ -47,10 +60,6 @@ void InvolutionData::classify_roots(const RootSystem& rs)
       d_real.insert(alpha);
     else
       d_complex.insert(alpha);
-
-  // find simple-imaginary roots
-  d_simpleImaginary=rs.simpleBasis(imaginary_roots());
-  d_simpleReal=rs.simpleBasis(real_roots());
 }
 
 // the follwing constructor intersects all root sets with those of |sub|, but
@@ -100,6 +109,19 @@ InvolutionData::InvolutionData(const RootSystem& rs,
   , d_simpleReal()
 { classify_roots(rs); }
 
+// this constructor avoids the (relatively costly) calls of |simpleBasis|
+InvolutionData::InvolutionData(const RootSystem& rs,
+			       const RootNbrList& s_image,
+			       const RootNbrList& simple_imaginary,
+			       const RootNbrList& simple_real)
+  : d_rootInvolution(rs.extend_to_roots(s_image))
+  , d_imaginary(rs.numRoots())
+  , d_real(rs.numRoots())
+  , d_complex(rs.numRoots())
+  , d_simpleImaginary(simple_imaginary)
+  , d_simpleReal(simple_real)
+{ sort_roots(rs); }
+
 InvolutionData InvolutionData::build
   (const RootSystem& rs,
    const TwistedWeylGroup& W,
@@ -399,6 +421,243 @@ TorusPart InvolutionTable::y_unlift(InvolutionNbr inv, const Weight& lift) const
   return TorusPart(v/2); // reduce coordinates modulo 2
 }
 
+namespace {
+
+// matrix entries are written in one byte if they all fit, otherwise in four
+void write_matrix(const int_Matrix& M, std::ostream& out)
+{
+  using basic_io::write_bytes;
+  bool small=true;
+  for (unsigned int i=0; i<M.numRows(); ++i)
+    for (unsigned int j=0; j<M.numColumns(); ++j)
+      small = small and M(i,j)>=-128 and M(i,j)<128;
+  const unsigned int width = small ? 1 : 4;
+  write_bytes<1>(M.numRows(),out);
+  write_bytes<1>(M.numColumns(),out);
+  write_bytes<1>(width,out);
+  for (unsigned int i=0; i<M.numRows(); ++i)
+    for (unsigned int j=0; j<M.numColumns(); ++j)
+      write_bytes(width,M(i,j),out);
+}
+
+int_Matrix read_matrix(std::istream& in)
+{
+  using basic_io::read_bytes;
+  const unsigned int rows = read_bytes<1>(in);
+  const unsigned int cols = read_bytes<1>(in);
+  const bool small = read_bytes<1>(in)==1;
+  int_Matrix M(rows,cols);
+  for (unsigned int i=0; i<rows; ++i)
+    for (unsigned int j=0; j<cols; ++j)
+      M(i,j) = small ? static_cast<signed char>(read_bytes<1>(in))
+	: static_cast<int>(read_bytes<4>(in));
+  return M;
+}
+
+/*
+  Root numbers depend on how the |RootDatum| was constructed (the dual
+  constructor numbers roots differently from the one from a |PreRootDatum|),
+  so roots are written in a form that does not: a byte giving the simple root
+  |s| (plus 128 for a negative root), a byte giving the length of a word |ww|,
+  and its letters, such that the (positive) root is |ww| applied to |s|. The
+  word is the descent path to a simple root, so its length is less than the
+  height of the root, which is less than |2*RANK_MAX|.
+*/
+void write_root(const RootDatum& rd, RootNbr alpha, std::ostream& out)
+{
+  using basic_io::write_bytes;
+  const bool negative = rd.is_negroot(alpha);
+  if (negative)
+    alpha = rd.rootMinus(alpha);
+  WeylWord ww;
+  while (not rd.is_simple_root(alpha))
+  {
+    const weyl::Generator s = rd.find_descent(alpha);
+    rd.simple_reflect_root(s,alpha);
+    ww.push_back(s);
+  }
+  write_bytes<1>(rd.simpleRootIndex(alpha)+(negative ? 128 : 0),out);
+  write_bytes<1>(ww.size(),out);
+  for (unsigned int i=0; i<ww.size(); ++i) // |ww| applies last letter first
+    write_bytes<1>(ww[i],out);
+}
+
+// read a root; sets the fail bit of |in| if the data are not valid for |rd|
+RootNbr read_root(const RootDatum& rd, std::istream& in)
+{
+  using basic_io::read_bytes;
+  const unsigned int code = read_bytes<1>(in);
+  WeylWord ww; ww.resize(read_bytes<1>(in));
+  bool valid = code%128<rd.semisimpleRank();
+  for (unsigned int i=0; i<ww.size(); ++i)
+    valid = (ww[i]=read_bytes<1>(in))<rd.semisimpleRank() and valid;
+  if (not valid)
+  {
+    in.setstate(std::ios_base::failbit);
+    return rd.simpleRootNbr(0);
+  }
+  const RootNbr alpha = rd.permuted_root(ww,rd.simpleRootNbr(code%128));
+  return code>=128 ? rd.rootMinus(alpha) : alpha;
+}
+
+void write_roots
+  (const RootDatum& rd, const RootNbrList& roots, std::ostream& out)
+{
+  basic_io::write_bytes<1>(roots.size(),out);
+  for (auto it=roots.begin(); it!=roots.end(); ++it)
+    write_root(rd,*it,out);
+}
+
+RootNbrList read_roots(const RootDatum& rd, std::istream& in)
+{
+  RootNbrList roots(basic_io::read_bytes<1>(in));
+  for (auto it=roots.begin(); it!=roots.end(); ++it)
+    *it = read_root(rd,in);
+  return roots;
+}
+
+// the positions in |roots| of its members taken in increasing order
+std::vector<unsigned int> increasing_order(const RootNbrList& roots)
+{
+  std::vector<unsigned int> result(roots.size());
+  for (unsigned int i=0; i<result.size(); ++i)
+    result[i]=i;
+  std::sort(result.begin(),result.end(),
+	    [&roots](unsigned int i, unsigned int j)
+	    { return roots[i]<roots[j]; });
+  return result;
+}
+
+// |roots| rearranged so that |result[k]==roots[order[k]]|
+RootNbrList rearranged
+  (const RootNbrList& roots, const std::vector<unsigned int>& order)
+{
+  RootNbrList result; result.reserve(order.size());
+  for (unsigned int k=0; k<order.size(); ++k)
+    result.push_back(roots[order[k]]);
+  return result;
+}
+
+} // |namespace|
+
+/*
+  Each involution is written as a reduced word for its Weyl group element (a
+  length in two bytes, then the letters, one byte each), its length and Weyl
+  length, the images of the simple roots (from which the root permutation is
+  cheaply recomputed), the simple imaginary and simple real roots (all roots
+  as by |write_root|), the matrices |theta|, |projector|, |M_real|, |lift_mat|, the
+  |diagonal| and the basis of |mod_space|. So reading an involution involves
+  neither the computation of |theta|, nor any matrix reduction, nor the search
+  for simple bases of the imaginary and real root subsystems.
+*/
+void InvolutionTable::write_involutions
+  (InvolutionNbr first, InvolutionNbr end, std::ostream& out) const
+{
+  using basic_io::write_bytes;
+  const WeylGroup& W = tW.weylGroup();
+  for (InvolutionNbr n=first; n<end; ++n)
+  {
+    const record& rec=data[n];
+    const WeylWord ww = W.word(involution(n));
+    write_bytes<2>(ww.size(),out);
+    for (size_t j=0; j<ww.size(); ++j)
+      write_bytes<1>(ww[j],out);
+    write_bytes<2>(rec.length,out);
+    write_bytes<2>(rec.W_length,out);
+    for (weyl::Generator s=0; s<semisimple_rank(); ++s)
+      write_root(rd,rec.id.root_involution(rd.simpleRootNbr(s)),out);
+    write_roots(rd,rec.id.imaginary_basis(),out);
+    write_roots(rd,rec.id.real_basis(),out);
+    write_matrix(rec.theta,out);
+    write_matrix(rec.projector,out);
+    write_matrix(rec.M_real,out);
+    write_matrix(rec.lift_mat,out);
+    write_bytes<1>(rec.diagonal.size(),out);
+    for (unsigned int i=0; i<rec.diagonal.size(); ++i)
+      write_bytes<4>(rec.diagonal[i],out);
+    write_bytes<1>(rec.mod_space.rank(),out);
+    write_bytes<1>(rec.mod_space.dimension(),out);
+    for (unsigned int i=0; i<rec.mod_space.dimension(); ++i)
+      write_bytes<4>(rec.mod_space.basis(i).data().to_ulong(),out);
+  }
+}
+
+/*
+  Read the |n| involutions of a Cartan orbit, starting with its canonical
+  involution; read everything before adding anything, so an incomplete file
+  changes nothing.
+
+  The simple imaginary and real roots are not just sets: for the canonical
+  involution they are listed in increasing order of root number (as found by
+  |simpleBasis|), and for the others in the order obtained from that one by
+  |cross_act|. Since the file may have been written for a root datum that
+  numbers its roots differently, we rearrange the lists read for the canonical
+  involution into increasing order, and all other lists the same way.
+*/
+bool InvolutionTable::read_involutions(InvolutionNbr n, std::istream& in)
+{
+  using basic_io::read_bytes;
+  const WeylGroup& W = tW.weylGroup();
+  std::vector<weyl::TI_Entry> invs; invs.reserve(n);
+  std::vector<record> recs; recs.reserve(n);
+  RootNbrList simple_images(semisimple_rank());
+  std::vector<unsigned int> imaginary_order, real_order; // set for |i==0|
+  for (InvolutionNbr i=0; i<n and in.good(); ++i)
+  {
+    WeylWord ww; ww.resize(read_bytes<2>(in));
+    for (size_t j=0; j<ww.size(); ++j)
+      if ((ww[j] = read_bytes<1>(in))>=semisimple_rank())
+	return false; // not a valid generator; the file is corrupt
+    invs.push_back(W.element(ww));
+    if (not unseen(invs.back()))
+      return false;
+    const unsigned int length = read_bytes<2>(in);
+    const unsigned int W_length = read_bytes<2>(in);
+    for (weyl::Generator s=0; s<semisimple_rank(); ++s)
+      simple_images[s] = read_root(rd,in);
+    const RootNbrList simple_imaginary = read_roots(rd,in);
+    const RootNbrList simple_real = read_roots(rd,in);
+    if (i==0)
+    {
+      imaginary_order = increasing_order(simple_imaginary);
+      real_order = increasing_order(simple_real);
+    }
+    else if (simple_imaginary.size()!=imaginary_order.size()
+	     or simple_real.size()!=real_order.size())
+      return false; // these sizes are constant on a Cartan orbit
+    const WeightInvolution theta = read_matrix(in);
+    const int_Matrix projector = read_matrix(in);
+    const int_Matrix M_real = read_matrix(in);
+    const int_Matrix lift_mat = read_matrix(in);
+    std::vector<int> diagonal(read_bytes<1>(in));
+    for (unsigned int i=0; i<diagonal.size(); ++i)
+      diagonal[i] = read_bytes<4>(in);
+    const unsigned int rank = read_bytes<1>(in);
+    SmallBitVectorList basis(read_bytes<1>(in),SmallBitVector(rank));
+    for (unsigned int i=0; i<basis.size(); ++i)
+      basis[i] = SmallBitVector
+	(BitSet<constants::RANK_MAX>(read_bytes<4>(in)),rank);
+    if (not in.good()) // file was truncated; ignore it
+      return false;
+    recs.push_back(record(theta,
+			  InvolutionData
+			    (rd,simple_images,
+			     rearranged(simple_imaginary,imaginary_order),
+			     rearranged(simple_real,real_order)),
+			  projector,M_real,diagonal,lift_mat,
+			  length,W_length,SmallSubspace(basis,rank)));
+  }
+
+  reserve(size()+n);
+  for (InvolutionNbr i=0; i<n; ++i)
+  {
+    hash.match(invs[i]);
+    data.push_back(std::move(recs[i]));
+  }
+  assert(data.size()==hash.size());
+  return true;
+}
+
 // ------------------------------ Cartan_orbit --------------------------------
 
 
@@ -437,11 +696,78 @@ void Cartan_orbits::add(InnerClass& G, CartanNbr cn)
   if (Cartan_index[cn]!=undefined)
     return; // class was already added before, so nothing to do
   Cartan_index[cn]=orbit.size(); // if not, it will be added at this position
+  profile::phase timer("involutions");
+
+  const std::vector<int> key = cache_key(G,cn);
+  if (read_cache(key,G,cn)) // then the orbit was added from a file
+  {
+    timer.count("involutions",orbit.back().size);
+    timer.count("read from cache");
+    return;
+  }
 
   // now actually generate the involutions associated to this Cartan class
   orbit.push_back(Cartan_orbit(static_cast<InvolutionTable&>(*this),G,cn));
+  timer.count("involutions",orbit.back().size);
+
+  write_cache(key,orbit.back()); // does nothing unless caching is enabled
+}
+
+/*
+  When a KGB cache directory is set, each orbit is written to a file there
+  after it is generated, and in a later session it is read from that file
+  instead (see |kgb::cache_file_name| for the file name and header). After the
+  header comes the number of involutions, then the involutions as written by
+  |InvolutionTable::write_involutions|, in the order they were generated. So
+  they are numbered just as if they had been generated in the current session.
+*/
+
+const int inv_cache_format=3; // increase when the file format changes
+
+// the key identifying a cache file: root datum, inner class, Cartan class
+std::vector<int> Cartan_orbits::cache_key(InnerClass& G, CartanNbr cn) const
+{
+  std::vector<int> key(1,inv_cache_format);
+  const std::vector<int> rd_key = kgb::root_datum_key(rd,delta);
+  key.insert(key.end(),rd_key.begin(),rd_key.end());
+
+  key.push_back(cn);
+  const WeylWord ww = tW.weylGroup().word(G.involution_of_Cartan(cn));
+  key.push_back(ww.size());
+  key.insert(key.end(),ww.begin(),ww.end());
+  return key;
 }
 
+bool Cartan_orbits::read_cache
+  (const std::vector<int>& key, InnerClass& G, CartanNbr cn)
+{
+  if (kgb::cache_directory().empty())
+    return false;
+  std::ifstream in
+    (kgb::cache_file_name("inv",key).c_str(),std::ios_base::binary);
+  if (not in.is_open() or not kgb::cache_header_matches(in,key))
+    return false;
+
+  const InvolutionNbr start = size();
+  const InvolutionNbr n = basic_io::read_bytes<4>(in);
+  if (not in.good() or n!=G.cartan(cn).orbitSize()
+      or not read_involutions(n,in))
+    return false;
+
+  orbit.push_back(Cartan_orbit(cn,start,n));
+  return true;
+} // |Cartan_orbits::read_cache|
+
+void Cartan_orbits::write_cache
+  (const std::vector<int>& key, const Cartan_orbit& orb) const
+{
+  kgb::write_cache_file("inv",key,[this,&orb](std::ostream& out)
+  {
+    basic_io::write_bytes<4>(orb.size,out);
+    write_involutions(orb.start,orb.end(),out);
+  });
+} // |Cartan_orbits::write_cache|
+
 unsigned int Cartan_orbits::locate(InvolutionNbr i) const
 {
   unsigned int low=0, high=orbit.size();
@@ -13,6 +13,7 @@
 #include <vector>
 #include <cassert>
 #include <functional>
+#include <iosfwd>
 
 #include "../Atlas.h"
 
@@ -32,6 +33,10 @@
    time, through a call to |Cartan_orbits::add| defined below. If user code
    should need additional information associated involutions, it might define
    an array indexed by |InvolutionNbr|; but currently this happens nowhere.
+
+   When a KGB cache directory is set (see |kgb::cache_directory|), each orbit
+   generated is also saved to a file there, and a later session reads the
+   orbit from that file rather than generating it again.
  */
 
 namespace atlas {
@@ -55,6 +60,10 @@ class InvolutionData
 		 const RootNbrSet& positive_subsystem);
   InvolutionData(const RootSystem& rs,
 		 const RootNbrList& simple_images);
+  InvolutionData(const RootSystem& rs, // when the simple bases are known
+		 const RootNbrList& simple_images,
+		 const RootNbrList& simple_imaginary,
+		 const RootNbrList& simple_real);
   static InvolutionData build(const RootSystem& rs,
 			      const TwistedWeylGroup& W,
 			      const TwistedInvolution& tw);
@@ -62,6 +71,7 @@ class InvolutionData
   // manipulators
 private:
   void classify_roots(const RootSystem& rs); // workhorse for contructors
+  void sort_roots(const RootSystem& rs); // the root sets only
 public:
   void cross_act(const Permutation& r_perm); // change (cheaply) to conjugate
 
@@ -228,6 +238,12 @@ class InvolutionTable
 
   void reserve(size_t s) { pool.reserve(s); }
 
+ protected: // for cache files of |Cartan_orbits|
+  void write_involutions
+    (InvolutionNbr first, InvolutionNbr end, std::ostream& out) const;
+  bool read_involutions // whether |n| new involutions were added from |in|
+    (InvolutionNbr n, std::istream& in);
+
 }; // |class InvolutionTable|
 
 struct Cartan_orbit
@@ -236,6 +252,8 @@ struct Cartan_orbit
   InvolutionNbr start,size;
 
   Cartan_orbit(InvolutionTable& i_tab,InnerClass& G, CartanNbr cn);
+  Cartan_orbit(CartanNbr cn, InvolutionNbr start, InvolutionNbr size)
+  : Cartan_class_nbr(cn), start(start), size(size) {} // orbit already there
 
   bool contains(InvolutionNbr i) const { return i-start<size; }
   InvolutionNbr end() const { return start+size; }
@@ -251,6 +269,13 @@ class Cartan_orbits : public InvolutionTable
   std::vector<unsigned int> Cartan_index; // maps Cartan number to its position
 
   unsigned int locate(InvolutionNbr i) const;
+
+  // identification of a cache file for the orbit of Cartan class |cn|
+  std::vector<int> cache_key(InnerClass& G, CartanNbr cn) const;
+  bool read_cache // whether the orbit was added from a file
+    (const std::vector<int>& key, InnerClass& G, CartanNbr cn);
+  void write_cache(const std::vector<int>& key, const Cartan_orbit& orb)
+    const;
 public:
   Cartan_orbits (const RootDatum& rd, const WeightInvolution& theta,
 		 const TwistedWeylGroup& tW)
@@ -128,6 +128,7 @@ RootSystem::RootSystem(const int_Matrix& Cartan_matrix)
   , ri()
   , two_rho_in_simple_roots(rk,0)
   , root_perm()
+  , pair_table()
 {
   if (rk==0)
     return; // avoid problems in trivial case
@@ -249,6 +250,7 @@ RootSystem::RootSystem(const int_Matrix& Cartan_matrix)
     root_perm[i].renumber(alpha_perm);
   }
 
+  tabulate_pairings();
 } // end of basic constructor
 
 RootSystem::RootSystem(const RootSystem& rs, tags::DualTag)
@@ -257,6 +259,7 @@ RootSystem::RootSystem(const RootSystem& rs, tags::DualTag)
   , ri(rs.ri)     // entries modified internally in non simply laced case
   , two_rho_in_simple_roots(rs.two_rho_in_simple_roots) // similar
   , root_perm(rs.root_perm) // unchanged
+  , pair_table(rs.pair_table) // transposed below in non simply laced case
 {
   bool simply_laced = true;
   for (size_t i=0; i<rk; ++i)
@@ -274,9 +277,40 @@ RootSystem::RootSystem(const RootSystem& rs, tags::DualTag)
       for (size_t i=0; i<rk; ++i)
 	two_rho_in_simple_roots[i]+=a[i]; // sum positive root expressions
     }
+
+    const size_t npos = numPosRoots();
+    for (RootNbr alpha=0; alpha<npos; ++alpha)
+      for (RootNbr beta=alpha+1; beta<npos; ++beta)
+	std::swap(pair_table[alpha*npos+beta],pair_table[beta*npos+alpha]);
   }
 } // end of dual constructor
 
+/*
+  Tabulate $\<\alpha,\beta^\vee>$ for all positive roots $\alpha,\beta$. Row
+  |alpha| is obtained by pairing |alpha| with the simple coroots, using the
+  Cartan matrix, after which |coroot_pairings| does the rest.
+*/
+void RootSystem::tabulate_pairings()
+{
+  const size_t npos = numPosRoots();
+  pair_table.resize(npos*npos);
+
+  int_Vector sp(rk);
+  for (RootNbr alpha=0; alpha<npos; ++alpha)
+  {
+    const Byte_vector& a = root(alpha);
+    for (size_t j=0; j<rk; ++j)
+    {
+      int c=0;
+      for (size_t i=0; i<rk; ++i)
+	c += a[i]*Cartan_entry(i,j);
+      sp[j]=c;
+    }
+    const int_Vector row = coroot_pairings(sp);
+    std::copy(row.begin(),row.end(),&pair_table[alpha*npos]);
+  }
+}
+
 
 int_Vector RootSystem::root_expr(RootNbr alpha) const
 {
@@ -438,21 +472,26 @@ LieType RootSystem::Lie_type() const
 LieType RootSystem::Lie_type(RootNbrList sub) const
 { return dynkin::Lie_type(cartanMatrix(sub)); }
 
-int
-RootSystem::bracket(RootNbr alpha, RootNbr beta) const // $\<\alpha,\beta^\vee>$
+/*
+  Each pairing is a sum of |rk| products, with the coroot $\beta^\vee$
+  expressed in simple coroots; this is cheaper than pairing with coroots
+  expressed in the coordinates of a root datum, whose rank may be larger.
+*/
+template<typename C>
+  matrix::Vector<C> RootSystem::coroot_pairings
+    (const matrix::Vector<C>& sp) const
 {
-  if (isOrthogonal(alpha,beta)) // this is quick
-    return 0;
-
-  const Byte_vector& row = root(rt_abs(alpha));
-  const Byte_vector& col = coroot(rt_abs(beta));
-
-  int c=0;
-  for (size_t i=0; i<rk; ++i)
+  assert(sp.size()==rk);
+  matrix::Vector<C> result(numPosRoots());
+  for (RootNbr beta=0; beta<numPosRoots(); ++beta)
+  {
+    const Byte_vector& cb = coroot(beta);
+    C c(0);
     for (size_t j=0; j<rk; ++j)
-      c += row[i]*Cartan_entry(i,j)*col[j];
-
-  return is_posroot(alpha)!=is_posroot(beta) ? -c : c;
+      c += cb[j]*sp[j];
+    result[beta]=c;
+  }
+  return result;
 }
 
 Permutation
@@ -966,28 +1005,66 @@ Coweight RootDatum::dual_twoRho(RootNbrSet rs) const
 
   Algorithm: the greedy algorithm -- if v is not positive, there is a
   simple coroot alpha^v such that <v,alpha^v> is < 0; then s_alpha.v takes
-  v closer to the dominant chamber.
+  v closer to the dominant chamber. Only the pairings of |v| with the simple
+  coroots matter here, and they are updated using the Cartan matrix: after
+  reflection by |s| the pairing with coroot |t| decreases by the old pairing
+  with coroot |s| times |cartan(s,t)|.
 */
 WeylWord RootDatum::to_dominant(Weight v) const
 {
+  const size_t r = semisimpleRank();
+  simple_pairings<int> pairing(*this,v); // |v| itself is not needed
+
   WeylWord result;
 
   weyl::Generator i;
   do
-    for (i=0; i<semisimpleRank(); ++i)
-      if (v.dot(simpleCoroot(i)) < 0)
+    for (i=0; i<r; ++i)
+      if (pairing[i] < 0)
       {
 	result.push_back(i);
-	simple_reflect(i,v);
+	pairing.reflect(i);
 	break;
       }
-  while (i<semisimpleRank());
+  while (i<r);
 
   // reverse result (action is from right to left)
   std::reverse(result.begin(),result.end());
   return result;
 }
 
+/*
+  Apply the simple reflections |*first|, |*(first+1)|, ... to |v|, in that
+  order, using |simple_pairings| to avoid computing a dot product and a vector
+  difference for each letter. For words not longer than the semisimple rank,
+  simply reflecting is cheaper.
+*/
+template<typename C, typename I>
+  void RootDatum::apply_letters(I first, I last, matrix::Vector<C>& v) const
+{
+  if (size_t(last-first)<=semisimpleRank())
+  {
+    for (; first!=last; ++first)
+      simple_reflect(*first,v);
+    return;
+  }
+
+  simple_pairings<C> pairing(*this,v);
+  for (; first!=last; ++first)
+    pairing.reflect(*first);
+  pairing.apply(v);
+}
+
+template<typename C>
+  matrix::Vector<C> RootDatum::posCoroot_pairings
+    (const matrix::Vector<C>& v) const
+{
+  matrix::Vector<C> sp(semisimpleRank());
+  for (weyl::Generator s=0; s<sp.size(); ++s)
+    sp[s] = simpleCoroot(s).dot(v);
+  return coroot_pairings(sp);
+}
+
 /*
   The matrix represented by ww.
 
@@ -1236,38 +1313,33 @@ WeightInvolution refl_prod(const RootNbrSet& rset, const RootDatum& rd)
 }
 
 
-RootDatum integrality_datum(const RootDatum& rd, const RatWeight& gamma)
+RootNbrSet integral_posroots(const RootDatum& rd, const RatWeight& gamma)
 {
   arithmetic::Numer_t n=gamma.denominator(); // signed type!
-  const Ratvec_Numer_t& v=gamma.numerator();
+  const Ratvec_Numer_t p=rd.posCoroot_pairings(gamma.numerator());
   RootNbrSet int_roots(rd.numRoots());
-  for (size_t i=0; i<rd.numPosRoots(); ++i)
-    if (rd.posCoroot(i).dot(v)%n == 0)
+  for (size_t i=0; i<p.size(); ++i)
+    if (p[i]%n == 0)
       int_roots.insert(rd.posRootNbr(i));
 
-  return rd.sub_datum(rd.simpleBasis(int_roots));
+  return int_roots;
 }
 
-unsigned int integrality_rank(const RootDatum& rd, const RatWeight& gamma)
-{
-  arithmetic::Numer_t n=gamma.denominator(); // signed type!
-  const Ratvec_Numer_t& v=gamma.numerator();
-  RootNbrSet int_roots(rd.numRoots());
-  for (size_t i=0; i<rd.numPosRoots(); ++i)
-    if (rd.posCoroot(i).dot(v)%n == 0)
-      int_roots.insert(rd.posRootNbr(i));
+RootDatum integrality_datum(const RootDatum& rd, const RatWeight& gamma)
+{ return rd.sub_datum(rd.simpleBasis(integral_posroots(rd,gamma))); }
 
-  return rd.simpleBasis(int_roots).size();
-}
+unsigned int integrality_rank(const RootDatum& rd, const RatWeight& gamma)
+{ return rd.simpleBasis(integral_posroots(rd,gamma)).size(); }
 
 RationalList integrality_points(const RootDatum& rd, const RatWeight& gamma)
 {
   arithmetic::Denom_t d = gamma.denominator(); // unsigned type is safe here
+  const Ratvec_Numer_t pairings = rd.posCoroot_pairings(gamma.numerator());
 
   std::set<arithmetic::Denom_t> products;
-  for (size_t i=0; i<rd.numPosRoots(); ++i)
+  for (auto it=pairings.begin(); it!=pairings.end(); ++it)
   {
-    arithmetic::Denom_t p = std::abs(rd.posCoroot(i).dot(gamma.numerator()));
+    arithmetic::Denom_t p = std::abs(*it);
     if (p!=0)
       products.insert(p);
   }
@@ -1390,6 +1462,26 @@ void RootSystem::toRootBasis
    const RootNbrList&) const;
 // this also  implicitly instantiates |RootSystem::toWeightBasis| twice
 
+template int_Vector RootSystem::coroot_pairings(const int_Vector&) const;
+template Ratvec_Numer_t RootSystem::coroot_pairings
+  (const Ratvec_Numer_t&) const;
+template int_Vector RootDatum::posCoroot_pairings(const int_Vector&) const;
+template Ratvec_Numer_t RootDatum::posCoroot_pairings
+  (const Ratvec_Numer_t&) const;
+
+template void RootDatum::apply_letters
+  (WeylWord::const_iterator, WeylWord::const_iterator,
+   matrix::Vector<int>&) const;
+template void RootDatum::apply_letters
+  (WeylWord::const_reverse_iterator, WeylWord::const_reverse_iterator,
+   matrix::Vector<int>&) const;
+template void RootDatum::apply_letters
+  (WeylWord::const_iterator, WeylWord::const_iterator,
+   matrix::Vector<arithmetic::Numer_t>&) const;
+template void RootDatum::apply_letters
+  (WeylWord::const_reverse_iterator, WeylWord::const_reverse_iterator,
+   matrix::Vector<arithmetic::Numer_t>&) const;
+
 } // |namespace rootdata|
 
 } // |namespace atlas|
@@ -63,6 +63,8 @@ RootNbrSet pos_to_neg (const RootSystem& rs, const WeylWord& w);
 // compute product of reflections in set of orthogonal roots
 WeightInvolution refl_prod(const RootNbrSet&, const RootDatum&);
 
+// positive roots whose coroots take integral values on |gamma|
+RootNbrSet integral_posroots(const RootDatum& rd, const RatWeight& gamma);
 RootDatum integrality_datum(const RootDatum& rd, const RatWeight& gamma);
 RationalList integrality_points(const RootDatum& rd, const RatWeight& gamma);
 unsigned int integrality_rank(const RootDatum& rd, const RatWeight& gamma);
@@ -111,6 +113,10 @@ class RootSystem
 // Root permutations induced by reflections in all positive roots.
   std::vector<Permutation> root_perm;
 
+// Pairings $\<\alpha,\beta^\vee>$ of positive roots, at |alpha*npos+beta|;
+// this takes an eighth of the space used by |root_perm|
+  Byte_vector pair_table;
+
   // internal access methods
   byte& Cartan_entry(weyl::Generator i, weyl::Generator j)
     { return Cmat[i*rk+j]; }
@@ -121,6 +127,8 @@ class RootSystem
   const Byte_vector& root(RootNbr i) const { return ri[i].root;}
   const Byte_vector& coroot(RootNbr i) const { return ri[i].dual;}
 
+  void tabulate_pairings(); // fill |pair_table|, once |ri| is complete
+
  public:
 
 // constructors and destructors
@@ -253,7 +261,16 @@ class RootSystem
   { return root_permutation(alpha)[beta]==beta; }
 
   // pairing between root |alpha| and coroot |beta|
-  int bracket(RootNbr alpha, RootNbr beta) const;
+  int bracket(RootNbr alpha, RootNbr beta) const
+  {
+    const int c = pair_table[rt_abs(alpha)*numPosRoots()+rt_abs(beta)];
+    return is_posroot(alpha)!=is_posroot(beta) ? -c : c;
+  }
+
+  // pairings with all positive coroots, by offset, of a weight given by its
+  // pairings |sp| with the simple coroots
+  template<typename C>
+    matrix::Vector<C> coroot_pairings(const matrix::Vector<C>& sp) const;
 
 
 
@@ -483,13 +500,14 @@ class RootDatum
   int scalarProduct(const Weight& v, RootNbr j) const
     { return v.dot(coroot(j)); }
 
+  // pairings of |v| with all positive coroots, indexed by positive root offset
+  template<typename C>
+    matrix::Vector<C> posCoroot_pairings(const matrix::Vector<C>& v) const;
+
   using RootSystem::isOrthogonal; // for the case of two RootNbr values
   bool isOrthogonal(const Weight& v, RootNbr j) const
     { return v.dot(coroot(j))==0; }
 
-  int cartan(weyl::Generator i, weyl::Generator j) const
-    { return simpleRoot(i).dot(simpleCoroot(j)); }
-
   // Apply reflection about root |alpha| to a weight |lambda|.
   template<typename C>
     void reflect(RootNbr alpha,matrix::Vector<C>& lambda) const
@@ -535,20 +553,16 @@ class RootDatum
     { simple_coreflect(ell,i); return ell; }
 
   WeylWord to_dominant(Weight lambda) const; // call by value
-  void act(const WeylWord& ww,Weight& lambda) const
-    {
-      for (weyl::Generator i=ww.size(); i-->0; )
-	simple_reflect(ww[i],lambda);
-    }
+  template<typename C>
+    void act(const WeylWord& ww,matrix::Vector<C>& lambda) const
+    { apply_letters(ww.rbegin(),ww.rend(),lambda); }
   Weight image_by(const WeylWord& ww,Weight lambda) const
     { act(ww,lambda); return lambda; }
 
   // with inverse we invert operands to remind how letters of |ww| are used
-  void act_inverse(Weight& lambda,const WeylWord& ww) const
-    {
-      for (weyl::Generator i=0; i<ww.size(); ++i)
-	simple_reflect(ww[i],lambda);
-    }
+  template<typename C>
+    void act_inverse(matrix::Vector<C>& lambda,const WeylWord& ww) const
+    { apply_letters(ww.begin(),ww.end(),lambda); }
 
   Weight image_by_inverse(Weight lambda,const WeylWord& ww) const
     { act_inverse(lambda,ww); return lambda; }
@@ -606,9 +620,55 @@ class RootDatum
 
   void fillStatus();
 
+  // apply simple reflections |*first|, |*(first+1)|, ... in that order
+  template<typename C, typename I>
+    void apply_letters(I first, I last, matrix::Vector<C>& v) const;
 
 }; // |class RootDatum|
 
+/*
+  A weight (or the numerator of a rational weight) represented, while simple
+  reflections are applied or multiples of simple roots are subtracted, by its
+  pairings with the simple coroots. These are stored inline, as the semisimple
+  rank never exceeds |constants::RANK_MAX|, and each operation updates them
+  using one row of the Cartan matrix. The multiples of simple roots subtracted
+  are recorded, and |apply| subtracts them from the weight itself at the end.
+*/
+template<typename C> class simple_pairings
+{
+  const RootDatum& rd;
+  const weyl::Generator r; // semisimple rank
+  C pairing[constants::RANK_MAX], coef[constants::RANK_MAX];
+
+ public:
+  simple_pairings(const RootDatum& rd, const matrix::Vector<C>& v)
+  : rd(rd), r(rd.semisimpleRank())
+  {
+    for (weyl::Generator s=0; s<r; ++s)
+    {
+      pairing[s] = rd.simpleCoroot(s).dot(v);
+      coef[s] = C(0);
+    }
+  }
+
+  C operator[] (weyl::Generator s) const { return pairing[s]; }
+
+  void subtract(weyl::Generator s, C c) // subtract |c| times simple root |s|
+  {
+    coef[s] += c;
+    for (weyl::Generator t=0; t<r; ++t)
+      pairing[t] -= c*rd.cartan(s,t);
+  }
+  void reflect(weyl::Generator s) { subtract(s,pairing[s]); }
+
+  void apply(matrix::Vector<C>& v) const // |v| must be the original weight
+  {
+    for (weyl::Generator s=0; s<r; ++s)
+      if (coef[s]!=C(0))
+	v.subtract(rd.simpleRoot(s).begin(),coef[s]);
+  }
+}; // |class simple_pairings|
+
 
 } // |namespace rootdata|
 
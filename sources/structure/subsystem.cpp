@@ -77,12 +77,7 @@ SubSystem::SubSystem(const RootDatum& parent,
 SubSystem SubSystem::integral // pseudo contructor for integral system
   (const RootDatum& parent, const RatWeight& gamma)
 {
-  arithmetic::Numer_t n=gamma.denominator(); // signed!
-  const Ratvec_Numer_t& v=gamma.numerator();
-  RootNbrSet int_roots(parent.numRoots());
-  for (size_t i=0; i<parent.numPosRoots(); ++i)
-    if (parent.posCoroot(i).dot(v)%n == 0)
-      int_roots.insert(parent.posRootNbr(i));
+  const RootNbrSet int_roots = rootdata::integral_posroots(parent,gamma);
 
   // it suffices that simpleBasis computed below live until end of constructor
   return SubSystem(parent,parent.simpleBasis(int_roots));
@@ -189,12 +184,7 @@ SubSystemWithGroup::SubSystemWithGroup(const RootDatum& parent,
 SubSystemWithGroup SubSystemWithGroup::integral // pseudo contructor
   (const RootDatum& parent, const RatWeight& gamma)
 {
-  arithmetic::Numer_t n=gamma.denominator(); // signed!
-  const Ratvec_Numer_t& v=gamma.numerator();
-  RootNbrSet int_coroots(parent.numRoots());
-  for (size_t i=0; i<parent.numPosRoots(); ++i)
-    if (parent.posCoroot(i).dot(v)%n == 0)
-      int_coroots.insert(parent.posRootNbr(i));
+  const RootNbrSet int_coroots = rootdata::integral_posroots(parent,gamma);
 
   // it suffices that simpleBasis computed below live until end of constructor
   return SubSystemWithGroup(parent,parent.simpleBasis(int_coroots));
@@ -604,17 +604,11 @@ void WeylGroup::act(const RootDatum& rd, const WeylElt& w, RootNbr& alpha) const
 }
 
 // Let |w| act on |v| according to reflection action in root datum |rd|
+// The root datum acts on the whole word at once, see |RootDatum::act|
 template<typename C>
   void WeylGroup::act
     (const RootDatum& rd, const WeylElt& w,  matrix::Vector<C>& v) const
-{
-  for (size_t i = d_rank; i-->0; )
-  {
-    const WeylWord& xw = wordPiece(w,i);
-    for (size_t j = xw.size(); j-->0; )
-      rd.simple_reflect(d_out[xw[j]],v);
-  }
-}
+{ rd.act(word(w),v); }
 
 void WeylGroup::act(const RootDatum& rd, const WeylElt& w, RatWeight& v) const
 { act(rd,w,v.numerator()); }
@@ -665,14 +659,7 @@ void WeylGroup::act(const PreRootDatum& prd, const WeylElt& w, LatticeMatrix& M)
 */
 void WeylGroup::inverse_act(const RootDatum& rd, const WeylElt& w, Weight& v)
   const
-{
-  for (size_t i=0; i<d_rank; ++i )
-  {
-    const WeylWord& xw = wordPiece(w,i);
-    for (size_t j=0; j<xw.size(); ++j )
-      rd.simple_reflect(d_out[xw[j]],v);
-  }
-}
+{ rd.act_inverse(v,word(w)); }
 
 /* One constructor for WeylElt was not defined in header file:
    construct the element from a Weyl word |ww| in a given Weyl group |W|
@@ -15,6 +15,7 @@
 #include <sstream>
 #include <cassert>
 #include <map>
+#include <chrono>
 
 #include "polynomials.h"
 #include "kgb.h"     // |kgb.size()|
@@ -116,6 +117,7 @@ namespace {
   void exam_f();
 
   void X_f();
+  void weightbench_f();
 
 /*
   For convenience, the "test" command is added to the mode that is flagged by
@@ -182,6 +184,9 @@ void addTestCommands<commands::MainmodeTag> (commands::CommandNode& mode)
 
   mode.add("X",X_f,"prints union of K\\G/B for real forms in inner class",
 	   commands::std_help);
+  mode.add("weightbench",weightbench_f,
+	   "times Weyl group action and rational weight arithmetic",
+	   commands::use_tag);
 
   if (testMode == MainMode)
     mode.add("test",test_f,test_tag);
@@ -350,6 +355,64 @@ void X_f()
   kgb_io::print_X(f,kgb);
 }
 
+/*
+  Time the action of the longest Weyl group element on a set of weights, once
+  reflecting letter by letter and once through |RootDatum::act|, and then the
+  rational weight operations most used in parameter computations. Results of
+  both ways of acting are checked to agree.
+*/
+void weightbench_f()
+{
+  typedef std::chrono::steady_clock clock;
+  const RootDatum& rd = commands::current_inner_class().rootDatum();
+  const WeylWord w0 = rd.to_dominant(-rd.twoRho());
+
+  std::vector<Weight> weights; // the roots, shifted by $2\rho$
+  for (RootNbr alpha=0; alpha<rd.numRoots(); ++alpha)
+    weights.push_back(rd.root(alpha)+rd.twoRho());
+  const unsigned reps = 1+4000000/(weights.size()*(w0.size()+1));
+
+  auto start = clock::now();
+  std::vector<Weight> letterwise = weights;
+  for (unsigned k=0; k<reps; ++k)
+    for (auto& v : letterwise)
+      for (auto it=w0.rbegin(); it!=w0.rend(); ++it)
+	rd.simple_reflect(*it,v);
+  const double t_letters =
+    std::chrono::duration<double>(clock::now()-start).count();
+
+  start = clock::now();
+  std::vector<Weight> paired = weights;
+  for (unsigned k=0; k<reps; ++k)
+    for (auto& v : paired)
+      rd.act(w0,v);
+  const double t_pairings =
+    std::chrono::duration<double>(clock::now()-start).count();
+
+  start = clock::now();
+  unsigned equal=0;
+  RatWeight sum(rd.rank());
+  for (unsigned k=0; k<reps; ++k)
+    for (const auto& v : weights)
+    {
+      RatWeight gamma(v,2+k%3); // vary denominators a bit
+      sum += gamma;
+      sum -= gamma;
+      if (sum==gamma)
+	++equal;
+      sum.normalize();
+    }
+  const double t_ratvec =
+    std::chrono::duration<double>(clock::now()-start).count();
+
+  std::cout << "Acting by w0 (length " << w0.size() << ") on "
+	    << weights.size() << " weights, " << reps << " times:\n"
+	    << "  letter by letter: " << t_letters << "s\n"
+	    << "  using pairings:   " << t_pairings << "s"
+	    << (letterwise==paired ? "" : " (results DIFFER)") << '\n'
+	    << "Rational weight sum, difference, comparison: "
+	    << t_ratvec << "s (" << equal << " equal)" << std::endl;
+}
 
 // Real mode functions
 
@@ -900,7 +963,7 @@ void test_f() // trial of twisted KLV computation
   else // convert to block number
     last=eblock.element(last);
 
-  std::vector<ext_kl::Pol> pool;
+  ext_kl::PolStore pool;
   ext_kl::KL_table twisted_KLV(eblock,pool);
   twisted_KLV.fill_columns(last);
 
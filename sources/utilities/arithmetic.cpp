@@ -17,7 +17,7 @@
 #include <cstdlib>
 
 #include "constants.h"
-#include "arithmetic.h"
+#include "bigint.h"
 #include "bits.h"
 #include "error.h"
 
@@ -105,8 +105,37 @@ Denom_t power(Denom_t x, unsigned int n)
   return result;
 }
 
-Rational& Rational::operator+=(Numer_t n) { num+=n*denom; return *this; }
-Rational& Rational::operator-=(Numer_t n) { num-=n*denom; return *this; }
+// like |power|, but throw |std::overflow_error| if the result does not fit
+Denom_t checked_power(Denom_t x, unsigned int n)
+{ if (n==0)
+    return 1;
+  if (x<=1)
+    return x;
+  unsigned int l=bits::lastBit(n); // now $n<2^l$
+  Denom_t result=1;
+  while (l-->0)
+  { result = checked_mul(result,result);
+    if ((n>>l & 1)!=0)
+      result = checked_mul(result,x);
+  }
+  return result;
+}
+
+/*
+  Operations on |Rational| values use checked arithmetic, so that a result
+  that cannot be represented raises |std::overflow_error| instead of being
+  silently wrong. To postpone overflow as much as possible, common factors are
+  cancelled before multiplying; in particular |operator+| forms the least
+  common multiple of the denominators rather than their product. Where an
+  intermediate value can overflow even though the final result fits (sums,
+  remainders and comparisons), the computation is then redone with |big_rat|
+  arithmetic, and only a result that does not fit raises the exception.
+*/
+
+Rational& Rational::operator+=(Numer_t n)
+{ num=checked_add(num,checked_mul(n,denominator())); return *this; }
+Rational& Rational::operator-=(Numer_t n)
+{ num=checked_sub(num,checked_mul(n,denominator())); return *this; }
 
 Rational& Rational::operator*=(Numer_t n)
 { if (n==0)
@@ -117,7 +146,7 @@ Rational& Rational::operator*=(Numer_t n)
     { n=-n; num=-num; }
     Numer_t d = unsigned_gcd(denom,n);
     denom/=d;
-    num *= static_cast<Numer_t>(n/d); // |n| implicitly converted to unsiged
+    num = checked_mul(num,static_cast<Numer_t>(n/d));
   }
   return *this; // result will be normalised if |this| was
 }
@@ -128,13 +157,13 @@ Rational& Rational::operator/=(Numer_t n)
   { n=-n; num=-num; }
   Numer_t d = unsigned_gcd(std::abs(num),n);
   num/=d;
-  denom *= n/d; // |n| implicitly converted to unsigned here
+  denom = checked_mul(denom,static_cast<Denom_t>(n/d));
   return *this; // result will be normalised if |this| was
 }
 
 Rational& Rational::operator%=(Numer_t n)
 { assert(n!=0);
-  num = remainder(num,denom*std::abs(n));
+  num = remainder(num,checked_mul(denom,static_cast<Denom_t>(std::abs(n))));
   return *this;
 }
 
@@ -142,38 +171,54 @@ Rational& Rational::operator%=(Numer_t n)
 
 Rational Rational::operator+(Rational q) const
 {
-  Denom_t sum_denom=lcm(denom,q.denom);
-  return Rational(num*Numer_t(sum_denom/denom)+q.num*Numer_t(sum_denom/q.denom),
-		  sum_denom);
+  const Denom_t g = unsigned_gcd(denom,q.denom), f = q.denom/g;
+  Numer_t a,b,n; Denom_t d;
+  if (mul_overflow(num,Numer_t(f),a) or mul_overflow(q.num,Numer_t(denom/g),b)
+      or add_overflow(a,b,n) or mul_overflow(denom,f,d))
+    return (big_rat(*this)+big_rat(q)).rat_val(); // the sum might still fit
+  return Rational(n,d);
 }
 Rational Rational::operator-(Rational q) const
 {
-  Denom_t sum_denom=lcm(denom,q.denom);
-  return Rational(num*Numer_t(sum_denom/denom)-q.num*Numer_t(sum_denom/q.denom),
-		  sum_denom);
+  const Denom_t g = unsigned_gcd(denom,q.denom), f = q.denom/g;
+  Numer_t a,b,n; Denom_t d;
+  if (mul_overflow(num,Numer_t(f),a) or mul_overflow(q.num,Numer_t(denom/g),b)
+      or sub_overflow(a,b,n) or mul_overflow(denom,f,d))
+    return (big_rat(*this)-big_rat(q)).rat_val();
+  return Rational(n,d);
 }
 
 Rational Rational::operator*(Rational q) const
 {
-  return Rational(num*q.num,denom*q.denom).normalize();
+  const Denom_t g1 = gcd(num,q.denom), g2 = gcd(q.num,denom);
+  return Rational(checked_mul(num/Numer_t(g1),q.num/Numer_t(g2)),
+		  checked_mul(denom/g2,q.denom/g1));
 }
 
 Rational Rational::operator/(Rational q) const
 {
   assert(q.num!=0);
-  if (q.num>0)
-    return Rational(num*Numer_t(q.denom),denom*q.num).normalize();
-  else
-    return Rational(-num*Numer_t(q.denom),denom*-q.num).normalize();
+  const Denom_t abs_q = std::abs(q.num);
+  const Denom_t g1 = gcd(num,abs_q), g2 = unsigned_gcd(denom,q.denom);
+  const Numer_t n = checked_mul(num/Numer_t(g1),Numer_t(q.denom/g2));
+  return Rational(q.num>0 ? n : -n, checked_mul(denom/g2,abs_q/g1));
 }
 
 Rational Rational::operator%(Rational q) const
 {
   assert(q.num!=0);
-  return Rational(remainder(num*Numer_t(q.denom),denom*std::abs(q.num)),
-		  denom*q.denom).normalize();
+  const Denom_t abs_q = std::abs(q.num);
+  Numer_t a; Denom_t m,d;
+  if (mul_overflow(num,Numer_t(q.denom),a) or mul_overflow(denom,abs_q,m)
+      or mul_overflow(denom,q.denom,d))
+    return (big_rat(*this)%big_rat(q)).rat_val();
+  return Rational(remainder(a,m),d);
 }
 
+// compare by cross multiplication, which is done exactly if it overflows
+bool Rational::less_by_big(Rational q) const
+{ return big_rat(*this)<big_rat(q); }
+
 Rational& Rational::power(int n)
 {
   normalize();
@@ -183,7 +228,9 @@ Rational& Rational::power(int n)
       throw std::runtime_error("Negative power of rational zero");
     std::swap(numer,denom); n=-n;
   }
-  numer = arithmetic::power(numer,n); denom = arithmetic::power(denom,n);
+  numer = checked_power(numer,n); denom = checked_power(denom,n);
+  if (numer>Denom_t(std::numeric_limits<Numer_t>::max()))
+    throw std::overflow_error("Integer overflow in rational power");
   num = (num>=0 or n%2==0 ? numer : - Numer_t(numer));
   return *this;
 }
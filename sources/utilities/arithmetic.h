@@ -13,6 +13,8 @@
 #include "arithmetic_fwd.h"
 
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 
 /******** function declarations **********************************************/
 
@@ -40,6 +42,17 @@ namespace arithmetic {
 
   Denom_t power(Denom_t base, unsigned int exponent);
 
+  // the following return whether the result (stored in |r|) wrapped around
+  template<typename I> bool add_overflow(I a, I b, I& r);
+  template<typename I> bool sub_overflow(I a, I b, I& r);
+  template<typename I> bool mul_overflow(I a, I b, I& r);
+
+  // the following throw |std::overflow_error| rather than wrap around
+  template<typename I> I checked_add(I a, I b);
+  template<typename I> I checked_sub(I a, I b);
+  template<typename I> I checked_mul(I a, I b);
+  Denom_t checked_power(Denom_t base, unsigned int exponent);
+
   template<typename I> int exp_minus_1 (I n) { return n%2==0 ? 1 : -1; }
   template<typename I> int exp_i (I n)
   { assert(n%2==0); return n%4==0 ? 1 : -1; }
@@ -94,22 +107,29 @@ public:
   Rational& operator%=(Numer_t n); // assumes $n\neq0$, will not throw
 
   // these definitions must use |denominator()| to ensure signed comparison
+  // values are normalised, so equality needs no cross multiplication
   bool operator==(Rational q) const
-    { return num*q.denominator()==denominator()*q.num; }
+    { return num==q.num and denom==q.denom; }
   bool operator!=(Rational q) const
-    { return num*q.denominator()!=denominator()*q.num; }
+    { return num!=q.num or denom!=q.denom; }
   bool operator<(Rational q)  const
-    { return num*q.denominator()<denominator()*q.num; }
+  { Numer_t a,b; // cross products, unless their computation overflows
+    return mul_overflow(num,q.denominator(),a) or
+      mul_overflow(denominator(),q.num,b) ? less_by_big(q) : a<b;
+  }
   bool operator<=(Rational q) const
-    { return num*q.denominator()<=denominator()*q.num; }
+    { return not q.operator<(*this); }
   bool operator>(Rational q)  const
-    { return num*q.denominator()>denominator()*q.num; }
+    { return q.operator<(*this); }
   bool operator>=(Rational q) const
-    { return num*q.denominator()>=denominator()*q.num; }
+    { return not operator<(q); }
 
   inline Rational& normalize();
   Rational& power(int n); // raise to power |n| and return |*this|
 
+private:
+  bool less_by_big(Rational q) const; // |operator<| for large cross products
+
 }; // |class Rational|
 
 
@@ -195,12 +215,81 @@ template<typename I>
       : b+~(~static_cast<Denom_t>(a)%b); // safe explicit conversion here
   }
 
+/*
+  Overflow detection, for operations whose result might not fit in |I|. The
+  functions |add_overflow| and so forth store the (possibly wrapped around)
+  result, and return whether it was wrong. Where the compiler provides
+  overflow builtins, the operation sets a flag that is tested afterwards, so
+  the common case costs a single predictable branch; elsewhere we compare
+  against the limits of |I| beforehand.
+*/
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__>=5)
+template<typename I> inline bool add_overflow(I a, I b, I& result)
+{ return __builtin_add_overflow(a,b,&result); }
+
+template<typename I> inline bool sub_overflow(I a, I b, I& result)
+{ return __builtin_sub_overflow(a,b,&result); }
+
+template<typename I> inline bool mul_overflow(I a, I b, I& result)
+{ return __builtin_mul_overflow(a,b,&result); }
+#else
+template<typename I> inline bool add_overflow(I a, I b, I& result)
+{ typedef std::numeric_limits<I> lim;
+  if (b>I(0) ? a>lim::max()-b : a<lim::min()-b)
+    return true;
+  result=a+b;
+  return false;
+}
+
+template<typename I> inline bool sub_overflow(I a, I b, I& result)
+{ typedef std::numeric_limits<I> lim;
+  if (b<I(0) ? a>lim::max()+b : a<lim::min()+b)
+    return true;
+  result=a-b;
+  return false;
+}
+
+template<typename I> inline bool mul_overflow(I a, I b, I& result)
+{ typedef std::numeric_limits<I> lim;
+  if (a!=I(0) and b!=I(0))
+  { const bool pos = (a>I(0))==(b>I(0)); // whether the product is positive
+    const I bound = (pos ? lim::max() : lim::min())/a; // truncated towards 0
+    if (a>I(0) ? (pos ? b>bound : b<bound) : (pos ? b<bound : b>bound))
+      return true;
+  }
+  result=a*b;
+  return false;
+}
+#endif
+
+// checked arithmetic, throwing |std::overflow_error| if the result is wrong
+template<typename I> inline I checked_add(I a, I b)
+{ I result;
+  if (add_overflow(a,b,result))
+    throw std::overflow_error("Integer overflow in addition");
+  return result;
+}
+
+template<typename I> inline I checked_sub(I a, I b)
+{ I result;
+  if (sub_overflow(a,b,result))
+    throw std::overflow_error("Integer overflow in subtraction");
+  return result;
+}
+
+template<typename I> inline I checked_mul(I a, I b)
+{ I result;
+  if (mul_overflow(a,b,result))
+    throw std::overflow_error("Integer overflow in multiplication");
+  return result;
+}
+
   inline Denom_t div_gcd (Denom_t d, Denom_t a) { return d/unsigned_gcd(a,d); }
 
   inline Denom_t gcd (Numer_t a, Denom_t b)
   {
-    if (a < 0)
-      return unsigned_gcd(static_cast<Denom_t>(-a),b);
+    if (a < 0) // negate after conversion, which is safe for the minimal |a|
+      return unsigned_gcd(-static_cast<Denom_t>(a),b);
     else
       return unsigned_gcd(static_cast<Denom_t>(a),b);
   }
@@ -0,0 +1,415 @@
+/*
+  This is bigint.cpp
+
+  part of the Atlas of Lie Groups and Representations
+
+  For license information see the LICENSE file
+*/
+
+#include "bigint.h"
+
+#include <cassert>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+/*
+  Here are the slow paths of |big_int| arithmetic, where values are given by a
+  sign and the sequence of their digits in base $2^{32}$, and the operations
+  of |big_rat|. The digit operations are the classical ones; division is done
+  by Knuth's algorithm D.
+*/
+
+namespace atlas {
+
+namespace arithmetic {
+
+namespace {
+
+  typedef std::uint32_t digit;
+  typedef std::uint64_t double_digit;
+  typedef std::vector<digit> digits;
+
+  const int digit_bits = 32;
+
+  digits to_digits(Denom_t n)
+  { digits result;
+    for (; n!=0; n>>=digit_bits)
+      result.push_back(digit(n));
+    return result;
+  }
+
+  void trim(digits& a) // remove leading zero digits
+  { while (not a.empty() and a.back()==0)
+      a.pop_back();
+  }
+
+  int compare(const digits& a, const digits& b) // both assumed trimmed
+  { if (a.size()!=b.size())
+      return a.size()<b.size() ? -1 : 1;
+    for (size_t i=a.size(); i-->0; )
+      if (a[i]!=b[i])
+	return a[i]<b[i] ? -1 : 1;
+    return 0;
+  }
+
+  digits add(const digits& a, const digits& b)
+  { if (a.size()<b.size())
+      return add(b,a);
+    digits result(a.size()+1);
+    double_digit carry=0;
+    for (size_t i=0; i<a.size(); ++i)
+    { carry += a[i];
+      if (i<b.size())
+	carry += b[i];
+      result[i]=digit(carry);
+      carry >>= digit_bits;
+    }
+    result[a.size()]=digit(carry);
+    trim(result);
+    return result;
+  }
+
+  digits subtract(const digits& a, const digits& b) // assumes $a\geq b$
+  { digits result(a.size());
+    digit borrow=0;
+    for (size_t i=0; i<a.size(); ++i)
+    { const double_digit t = double_digit(b.size()>i ? b[i] : 0)+borrow;
+      result[i]=digit(a[i]-t);
+      borrow = a[i]<t ? 1 : 0;
+    }
+    assert(borrow==0);
+    trim(result);
+    return result;
+  }
+
+  digits multiply(const digits& a, const digits& b)
+  { if (a.empty() or b.empty())
+      return digits();
+    digits result(a.size()+b.size(),0);
+    for (size_t i=0; i<a.size(); ++i)
+    { double_digit carry=0;
+      for (size_t j=0; j<b.size(); ++j)
+      { carry += double_digit(a[i])*b[j]+result[i+j];
+	result[i+j]=digit(carry);
+	carry >>= digit_bits;
+      }
+      result[i+b.size()]=digit(carry);
+    }
+    trim(result);
+    return result;
+  }
+
+  digit divide_by_digit(digits& a, digit d) // |a/=d| and return remainder
+  { double_digit rem=0;
+    for (size_t i=a.size(); i-->0; )
+    { rem = rem<<digit_bits | a[i];
+      a[i]=digit(rem/d);
+      rem %= d;
+    }
+    trim(a);
+    return digit(rem);
+  }
+
+/*
+  Set |q| and |r| to the quotient and remainder of $u/v$. This is Knuth's
+  algorithm D (TAOCP 4.3.1): after shifting both operands so that the leading
+  digit of |v| has its high bit set, each quotient digit is estimated from the
+  leading two digits of the current remainder, and that estimate is at most 2
+  too large; it is corrected before, or (rarely) after, subtraction.
+*/
+  void divide(const digits& u, const digits& v, digits& q, digits& r)
+  { assert(not v.empty());
+    if (compare(u,v)<0)
+    { q.clear(); r=u; return; }
+    if (v.size()==1)
+    { q=u; r=to_digits(divide_by_digit(q,v[0])); return; }
+
+    const size_t n=v.size(), m=u.size()-n;
+    const double_digit base = double_digit(1)<<digit_bits;
+    unsigned int s=0; // normalising shift
+    while ((v.back()<<s & (digit(1)<<(digit_bits-1)))==0)
+      ++s;
+
+    digits vn(n), un(u.size()+1);
+    for (size_t i=n; i-->1; )
+      vn[i] = v[i]<<s | (s==0 ? 0 : v[i-1]>>(digit_bits-s));
+    vn[0] = v[0]<<s;
+    un[u.size()] = s==0 ? 0 : u.back()>>(digit_bits-s);
+    for (size_t i=u.size(); i-->1; )
+      un[i] = u[i]<<s | (s==0 ? 0 : u[i-1]>>(digit_bits-s));
+    un[0] = u[0]<<s;
+
+    q.assign(m+1,0);
+    for (size_t j=m+1; j-->0; )
+    { const double_digit top = double_digit(un[j+n])<<digit_bits | un[j+n-1];
+      double_digit q_hat = top/vn[n-1], r_hat = top%vn[n-1];
+      while (q_hat>=base or q_hat*vn[n-2] > (r_hat<<digit_bits | un[j+n-2]))
+      { --q_hat; r_hat += vn[n-1];
+	if (r_hat>=base)
+	  break;
+      }
+
+      // subtract |q_hat*vn| from the digits of |un| starting at |j|
+      double_digit carry=0; std::int64_t t; digit borrow=0;
+      for (size_t i=0; i<n; ++i)
+      { const double_digit p = q_hat*vn[i]+carry;
+	carry = p>>digit_bits;
+	t = std::int64_t(un[i+j]) - borrow - std::int64_t(p & (base-1));
+	un[i+j] = digit(t);
+	borrow = t<0 ? 1 : 0;
+      }
+      t = std::int64_t(un[j+n]) - borrow - std::int64_t(carry);
+      un[j+n] = digit(t);
+
+      if (t<0) // then |q_hat| was one too large; add |vn| back
+      { --q_hat;
+	carry=0;
+	for (size_t i=0; i<n; ++i)
+	{ carry += double_digit(un[i+j])+vn[i];
+	  un[i+j]=digit(carry);
+	  carry >>= digit_bits;
+	}
+	un[j+n] += digit(carry);
+      }
+      q[j]=digit(q_hat);
+    }
+
+    r.resize(n);
+    for (size_t i=0; i<n; ++i) // undo the normalising shift
+      r[i] = un[i]>>s | (s==0 ? 0 : un[i+1]<<(digit_bits-s));
+    trim(q); trim(r);
+  }
+
+} // |namespace|
+
+/*****************************************************************************
+
+        Chapter I -- The |big_int| class
+
+******************************************************************************/
+
+big_int::big_int(bool negative, digits&& m)
+: small(0), neg(false), mag()
+{ trim(m);
+  if (m.size()<=2)
+  { const Denom_t v = m.empty() ? 0
+      : m.size()==1 ? m[0] : Denom_t(m[1])<<digit_bits | m[0];
+    const Denom_t bound = // largest absolute value fitting |Numer_t|
+      Denom_t(std::numeric_limits<Numer_t>::max())+(negative ? 1 : 0);
+    if (v<=bound)
+    { small = negative ? Numer_t(-v) : Numer_t(v); return; }
+  }
+  neg=negative; mag=std::move(m);
+}
+
+big_int big_int::from_unsigned(Denom_t n)
+{ return n<=Denom_t(std::numeric_limits<Numer_t>::max())
+    ? big_int(Numer_t(n)) : big_int(false,to_digits(n));
+}
+
+big_int::digits big_int::abs_digits() const
+{ if (not is_small())
+    return mag;
+  return to_digits(small<0 ? -Denom_t(small) : Denom_t(small));
+}
+
+int big_int::int_val() const
+{ if (not is_small() or small<std::numeric_limits<int>::min()
+      or small>std::numeric_limits<int>::max())
+    throw std::overflow_error("Integer value too large for conversion");
+  return int(small);
+}
+
+Numer_t big_int::long_val() const
+{ if (not is_small())
+    throw std::overflow_error("Integer value too large for conversion");
+  return small;
+}
+
+Denom_t big_int::ulong_val() const
+{ if (is_negative())
+    throw std::overflow_error("Negative integer value in unsigned conversion");
+  if (is_small())
+    return small;
+  if (mag.size()>2)
+    throw std::overflow_error("Integer value too large for conversion");
+  return Denom_t(mag[1])<<digit_bits | mag[0];
+}
+
+big_int big_int::operator-() const
+{ if (is_small() and small!=std::numeric_limits<Numer_t>::min())
+    return big_int(-small);
+  return big_int(not is_negative(),abs_digits());
+}
+
+big_int big_int::sum(const big_int& x, bool subtract_x) const
+{ const bool x_neg = x.is_negative()!=subtract_x; // sign of term added
+  const digits a=abs_digits(), b=x.abs_digits();
+  if (is_negative()==x_neg)
+    return big_int(x_neg,add(a,b));
+  return arithmetic::compare(a,b)>=0 ? big_int(is_negative(),subtract(a,b))
+			 : big_int(x_neg,subtract(b,a));
+}
+
+big_int big_int::product(const big_int& x) const
+{ return big_int(is_negative()!=x.is_negative(),
+		 multiply(abs_digits(),x.abs_digits()));
+}
+
+big_int big_int::div_mod(const big_int& d, big_int& rem) const
+{ assert(d.is_positive());
+  if (is_small() and d.is_small())
+  { rem = big_int(Numer_t(remainder(small,Denom_t(d.small))));
+    return big_int(arithmetic::divide(small,Denom_t(d.small)));
+  }
+  digits q,r;
+  divide(abs_digits(),d.abs_digits(),q,r);
+  if (not is_negative())
+  { rem = big_int(false,std::move(r));
+    return big_int(false,std::move(q));
+  }
+  if (r.empty()) // exact division of a negative number
+  { rem = big_int(0);
+    return big_int(true,std::move(q));
+  }
+  rem = d-big_int(false,std::move(r)); // the quotient is rounded downwards
+  return -(big_int(false,std::move(q))+big_int(1));
+}
+
+big_int big_int::power(unsigned int n) const
+{ big_int result(1), base(*this);
+  for (; n!=0; n>>=1)
+  { if ((n&1)!=0)
+      result*=base;
+    if (n>1)
+      base*=base;
+  }
+  return result;
+}
+
+int big_int::compare(const big_int& x) const
+{ if (is_small() and x.is_small())
+    return small<x.small ? -1 : small>x.small ? 1 : 0;
+  if (is_negative()!=x.is_negative())
+    return is_negative() ? -1 : 1;
+  const int c = arithmetic::compare(abs_digits(),x.abs_digits());
+  return is_negative() ? -c : c;
+}
+
+big_int gcd(big_int a, big_int b)
+{ if (a.is_negative())
+    a=-a;
+  if (b.is_negative())
+    b=-b;
+  while (not b.is_zero())
+  { if (a.is_small() and b.is_small()) // finish with machine arithmetic
+      return big_int::from_unsigned(unsigned_gcd(a.small,b.small));
+    big_int r;
+    a.div_mod(b,r);
+    a=std::move(b); b=std::move(r);
+  }
+  return a;
+}
+
+std::ostream& operator<<(std::ostream& out, const big_int& x)
+{ if (x.is_small())
+    return out << x.small;
+  const digit chunk = 1000000000; // print in groups of 9 decimal digits
+  digits m = x.mag;
+  std::vector<digit> groups;
+  while (not m.empty())
+    groups.push_back(divide_by_digit(m,chunk));
+  if (x.neg)
+    out << '-';
+  out << groups.back();
+  const char fill = out.fill('0');
+  for (size_t i=groups.size()-1; i-->0; )
+    out << std::setw(9) << groups[i];
+  out.fill(fill);
+  return out;
+}
+
+/*****************************************************************************
+
+        Chapter II -- The |big_rat| class
+
+******************************************************************************/
+
+big_rat::big_rat(Rational q)
+: num(q.numerator())
+, denom(big_int::from_unsigned(Denom_t(q.denominator())))
+{}
+
+big_rat::big_rat(const big_int& n, const big_int& d)
+: num(n), denom(d)
+{ assert(not d.is_zero());
+  if (denom.is_negative())
+  { num=-num; denom=-denom; }
+  const big_int g = gcd(num,denom);
+  if (g!=big_int(1))
+  { big_int r;
+    num=num.div_mod(g,r); denom=denom.div_mod(g,r);
+  }
+}
+
+Rational big_rat::rat_val() const
+{ if (not (num.is_small() and denom.is_small()))
+    throw std::overflow_error("Rational value too large for conversion");
+  return Rational(num.long_val(),denom.long_val());
+}
+
+big_rat big_rat::operator+(const big_rat& q) const
+{ return big_rat(num*q.denom+q.num*denom,denom*q.denom);
+}
+
+big_rat big_rat::operator-(const big_rat& q) const
+{ return big_rat(num*q.denom-q.num*denom,denom*q.denom);
+}
+
+big_rat big_rat::operator*(const big_rat& q) const
+{ return big_rat(num*q.num,denom*q.denom);
+}
+
+big_rat big_rat::operator/(const big_rat& q) const
+{ assert(not q.is_zero());
+  return big_rat(num*q.denom,denom*q.num);
+}
+
+// the result lies in $[0,|q|)$, and differs from |*this| by a multiple of |q|
+big_rat big_rat::operator%(const big_rat& q) const
+{ assert(not q.is_zero());
+  big_int r;
+  (num*q.denom).div_mod(denom*(q.num.is_negative() ? -q.num : q.num),r);
+  return big_rat(r,denom*q.denom);
+}
+
+big_rat big_rat::inverse() const
+{ assert(not is_zero());
+  return num.is_negative() ? big_rat(-denom,-num,normalised_tag())
+			   : big_rat(denom,num,normalised_tag());
+}
+
+big_rat big_rat::power(int n) const
+{ if (n<0 and is_zero())
+    throw std::runtime_error("Negative power of rational zero");
+  const big_rat b = n<0 ? inverse() : *this;
+  const unsigned int e = n<0 ? -static_cast<unsigned int>(n) : n;
+  return big_rat(b.num.power(e),b.denom.power(e),normalised_tag());
+}
+
+big_int big_rat::floor() const
+{ big_int r; return num.div_mod(denom,r); }
+
+big_int big_rat::ceil() const
+{ big_int r; return -(-num).div_mod(denom,r); }
+
+int big_rat::compare(const big_rat& q) const
+{ return (num*q.denom).compare(q.num*denom); }
+
+std::ostream& operator<<(std::ostream& out, const big_rat& q)
+{ return out << q.numerator() << '/' << q.denominator(); }
+
+} // |namespace arithmetic|
+
+} // |namespace atlas|
@@ -0,0 +1,163 @@
+/*
+  This is bigint.h
+
+  part of the Atlas of Lie Groups and Representations
+
+  For license information see the LICENSE file
+*/
+
+/* Integers and rationals of unbounded size, for the interpreter */
+
+#ifndef BIGINT_H  /* guard against multiple inclusions */
+#define BIGINT_H
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "arithmetic.h"
+
+namespace atlas {
+
+namespace arithmetic {
+
+/******** type definitions **************************************************/
+
+/*
+  A |big_int| holds an integer of arbitrary size. As long as the value fits in
+  a |Numer_t| it is stored as such, and operations take a fast path that only
+  checks for overflow (by the helpers in \.{arithmetic.h}); when overflow
+  happens the operation is redone on the digits of the operands in base
+  $2^{32}$, and the result is stored as a sign and such a sequence of digits.
+  Results are always converted back to the small form when they fit, so that
+  the two forms never represent the same value.
+*/
+class big_int
+{
+  typedef std::uint32_t digit;
+  typedef std::vector<digit> digits; // little-endian, no leading zero digits
+
+  Numer_t small; // the value, if |mag.empty()|
+  bool neg; // the sign, if |not mag.empty()|
+  digits mag; // if nonempty, the absolute value, which does not fit |small|
+
+ public:
+  big_int(Numer_t n=0) : small(n), neg(false), mag() {} // implicit conversion
+  static big_int from_unsigned(Denom_t n);
+
+  bool is_small() const { return mag.empty(); }
+  bool is_zero() const { return is_small() and small==0; }
+  bool is_negative() const { return is_small() ? small<0 : neg; }
+  bool is_positive() const { return is_small() ? small>0 : not neg; }
+
+  // conversions; these throw |std::overflow_error| if the value does not fit
+  int int_val() const;
+  Numer_t long_val() const;
+  Denom_t ulong_val() const; // in addition requires the value non-negative
+
+  big_int operator-() const;
+  big_int operator+(const big_int& x) const
+  { Numer_t r;
+    if (is_small() and x.is_small() and not add_overflow(small,x.small,r))
+      return big_int(r);
+    return sum(x,false);
+  }
+  big_int operator-(const big_int& x) const
+  { Numer_t r;
+    if (is_small() and x.is_small() and not sub_overflow(small,x.small,r))
+      return big_int(r);
+    return sum(x,true);
+  }
+  big_int operator*(const big_int& x) const
+  { Numer_t r;
+    if (is_small() and x.is_small() and not mul_overflow(small,x.small,r))
+      return big_int(r);
+    return product(x);
+  }
+
+  big_int& operator+=(const big_int& x) { return *this = *this+x; }
+  big_int& operator-=(const big_int& x) { return *this = *this-x; }
+  big_int& operator*=(const big_int& x) { return *this = *this*x; }
+
+  // floor division by |d>0|; sets |rem| to the remainder, which is in $[0,d)$
+  big_int div_mod(const big_int& d, big_int& rem) const;
+  big_int power(unsigned int n) const;
+
+  int compare(const big_int& x) const; // sign of |*this-x|
+  bool operator==(const big_int& x) const { return compare(x)==0; }
+  bool operator!=(const big_int& x) const { return compare(x)!=0; }
+  bool operator<(const big_int& x) const { return compare(x)<0; }
+  bool operator<=(const big_int& x) const { return compare(x)<=0; }
+  bool operator>(const big_int& x) const { return compare(x)>0; }
+  bool operator>=(const big_int& x) const { return compare(x)>=0; }
+
+  friend big_int gcd(big_int a, big_int b); // non-negative; |gcd(0,0)==0|
+  friend std::ostream& operator<<(std::ostream& out, const big_int& x);
+
+ private:
+  big_int(bool negative, digits&& m); // converts to small form if possible
+  digits abs_digits() const;
+  big_int sum(const big_int& x, bool subtract) const; // the slow paths
+  big_int product(const big_int& x) const;
+}; // |class big_int|
+
+big_int gcd(big_int a, big_int b);
+
+/*
+  A |big_rat| is a rational number with |big_int| numerator and denominator,
+  kept normalised (positive denominator, no common factors). Operations are
+  done by |big_int| arithmetic, so they stay on its fast path as long as the
+  numbers involved are small. This class also serves |Rational| arithmetic,
+  which falls back to it when an intermediate result overflows.
+*/
+class big_rat
+{
+  big_int num, denom;
+
+ public:
+  big_rat(Rational q); // implicit conversion
+  explicit big_rat(const big_int& n) : num(n), denom(1) {}
+  big_rat(const big_int& n, const big_int& d); // normalises; requires |d!=0|
+
+  const big_int& numerator() const { return num; }
+  const big_int& denominator() const { return denom; }
+  Rational rat_val() const; // throws |std::overflow_error| if it does not fit
+
+  bool is_zero() const { return num.is_zero(); }
+  bool is_negative() const { return num.is_negative(); }
+  bool is_positive() const { return num.is_positive(); }
+
+  big_rat operator-() const { return big_rat(-num,denom,normalised_tag()); }
+  big_rat operator+(const big_rat& q) const;
+  big_rat operator-(const big_rat& q) const;
+  big_rat operator*(const big_rat& q) const;
+  big_rat operator/(const big_rat& q) const; // assumes $q\neq0$
+  big_rat operator%(const big_rat& q) const; // assumes $q\neq0$
+  big_rat inverse() const; // assumes |*this| nonzero
+  big_rat power(int n) const; // throws |std::runtime_error| for 0 to power <0
+
+  big_int floor() const;
+  big_int ceil() const;
+
+  int compare(const big_rat& q) const; // sign of |*this-q|
+  bool operator==(const big_rat& q) const
+  { return num==q.num and denom==q.denom; } // since both are normalised
+  bool operator!=(const big_rat& q) const { return not operator==(q); }
+  bool operator<(const big_rat& q) const { return compare(q)<0; }
+  bool operator<=(const big_rat& q) const { return compare(q)<=0; }
+  bool operator>(const big_rat& q) const { return compare(q)>0; }
+  bool operator>=(const big_rat& q) const { return compare(q)>=0; }
+
+ private:
+  struct normalised_tag {}; // selects the constructor that does not normalise
+  big_rat(const big_int& n, const big_int& d, normalised_tag)
+  : num(n), denom(d) {}
+}; // |class big_rat|
+
+std::ostream& operator<<(std::ostream& out, const big_rat& q);
+
+} // |namespace arithmetic|
+
+} // |namespace atlas|
+
+#endif
@@ -12,6 +12,7 @@
 #define BITMAP_H
 
 #include <vector>
+#include <utility> // |std::move|
 #include <cassert>
 
 #include "bitmap_fwd.h"
@@ -93,6 +94,10 @@ class BitMap
 
   //! \brief Copy constructor
   BitMap(const BitMap& b) : d_capacity(b.d_capacity), d_map(b.d_map) {}
+  // moving must not throw, so that vectors of structures holding a |BitMap|
+  // (like |InvolutionTable| records) are moved rather than copied on growth
+  BitMap(BitMap&& b) noexcept
+  : d_capacity(b.d_capacity), d_map(std::move(b.d_map)) {}
 
   // convert range defined by iterators into a BitMap
   template <typename I>
@@ -114,6 +119,8 @@ class BitMap
 
 // assignment
   BitMap& operator= (const BitMap&);
+  BitMap& operator= (BitMap&& b) noexcept
+  { d_capacity=b.d_capacity; d_map=std::move(b.d_map); return *this; }
 
 // accessors
   /*!
@@ -0,0 +1,132 @@
+/*
+  This is concurrent_hashtable.h
+
+  part of the Atlas of Lie Groups and Representations
+
+  For license information see the LICENSE file
+*/
+
+
+#ifndef CONCURRENT_HASHTABLE_H
+#define CONCURRENT_HASHTABLE_H
+
+#include "hashtable_fwd.h"
+#include <cstddef>
+#include <vector>
+#include <mutex>
+
+#include "constants.h"
+
+namespace atlas {
+namespace hashtable {
+
+  /* The |ConcurrentHashTable| template class is a variant of |HashTable| that
+     can be used by several threads simultaneously. The requirements for the
+     type parameters |Entry| and |Number| are as for |HashTable|, and the
+     interface is mostly the same: |match| returns the sequence number of its
+     argument, after adding it to the pool if it was absent, |find| only looks
+     up, and |reconstruct| must be called after others changed the pool.
+
+     In addition the container |Entry::Pooltype| must not relocate its
+     elements when growing (|containers::segmented_vector| is suitable, but
+     |std::vector| is not), since threads look at existing elements while
+     another thread adds an element to the pool. Moreover |hashCode| should
+     compute its result by masking a hash value by |modulus-1|, since it will be
+     called with a huge modulus to obtain a hash value with many bits.
+
+     The slots are partitioned into |n_shards| independent sub-tables called
+     shards, each protected by its own mutex; the low bits of the hash value
+     select the shard, and the remaining bits a slot within it. Threads only
+     contend when they access the same shard at the same time, and only the
+     actual extension of the pool is serialised across all shards. Each shard
+     is resized on its own when it fills up, which involves rehashing only the
+     entries that belong to it; therefore no single insertion pays for
+     rehashing the whole table, and other threads continue using the other
+     shards while one shard is being resized.
+
+     Numbering of entries is in order of insertion, as for |HashTable|, so
+     when several threads insert, the numbering depends on timing. The method
+     |renumber| can be used afterwards to impose a chosen numbering, and
+     |renumber_by_use| imposes the numbering by first occurrence in lists of
+     sequence numbers, while also permuting the pool to match.
+  */
+
+template <class Entry, typename Number>
+class ConcurrentHashTable
+{
+  enum { shard_shift = 6, n_shards = 1<<shard_shift };
+
+  struct Shard
+  {
+    mutable std::mutex lock;
+    size_t mod; // number of slots of this shard, a power of 2
+    size_t count; // number of occupied slots
+    std::vector<Number> hash;
+    char padding[64]; // keep locks of neighbouring shards in separate caches
+
+    Shard() : lock(), mod(initial_mod), count(0), hash(mod,empty) {}
+  };
+
+  // data members
+  Shard shard[n_shards];
+  std::mutex pool_lock; // serialises additions to |d_pool|
+  typename Entry::Pooltype& d_pool;
+
+  // interface
+ public:
+
+  // static constants
+  static const Number empty; // code for empty slot in a shard
+  static const float fill_fraction; // maximal proportion of occupied slots
+  static const size_t initial_mod = 16; // initial number of slots per shard
+
+  // constructor
+  ConcurrentHashTable(typename Entry::Pooltype& pool); // caller supplies pool
+
+  // manipulator
+  Number match(const Entry&);   // lookup entry and return its sequence number
+
+  // accessors
+  Number find(const Entry&) const; // const variant of match; may return empty
+  typename Entry::Pooltype::const_reference operator[] (Number i) const
+    { return d_pool[i]; }
+
+  // the following two are only reliable when no other thread modifies table
+  Number size() const { return Number(d_pool.size()); }
+  size_t capacity () const; // total number of slots
+
+  // the following manipulators must not be called concurrently with others
+  void reconstruct(); // must call when |d_pool| has been changed by others
+
+  // give entries |from+k| the number |new_nr[k]|, a permutation of that range;
+  // the caller must then permute the entries of |d_pool| correspondingly
+  void renumber(Number from, const std::vector<Number>& new_nr);
+
+  // renumber entries from |from| on by first occurrence in the lists in
+  // $[begin,end)$, each scanned from its end, changing the lists accordingly,
+  // and move the entries in |d_pool|, which must provide |interchange|
+  template<typename ListIterator>
+    void renumber_by_use(Number from, ListIterator begin, ListIterator end);
+
+ private: // auxiliary functions
+  static size_t hash_value(const Entry& x) // hash with many significant bits
+    { return x.hashCode(constants::hiBit); }
+  static size_t max_fill(size_t mod) // maximal number of slots occupied
+    { return static_cast<size_t>(fill_fraction*mod); }
+
+  // find slot in |s| for |x| with hash value |h|; it is empty if |x| is absent
+  size_t locate(const Shard& s, size_t h, const Entry& x) const;
+
+  // insert number |i| with hash value |h| into |s|, knowing it to be absent
+  void insert(Shard& s, size_t h, Number i);
+
+  void grow(Shard& s); // double the number of slots of |s|, and rehash it
+
+}; // |class ConcurrentHashTable|
+
+} // |namespace hashtable|
+} // |namespace atlas|
+
+#include "concurrent_hashtable_def.h"
+
+#endif
@@ -0,0 +1,210 @@
+#include <cassert>
+#include <stdexcept>
+
+#include "profile.h" // counting rehashes
+
+namespace atlas {
+namespace hashtable {
+
+/* template class constants must be defined outside class definition */
+
+template <class Entry, typename Number>
+  const Number ConcurrentHashTable<Entry,Number>::empty = ~Number(0);
+
+template <class Entry, typename Number>
+  const float ConcurrentHashTable<Entry,Number>::fill_fraction=0.8;
+
+template <class Entry, typename Number>
+  const size_t ConcurrentHashTable<Entry,Number>::initial_mod;
+
+/* the constructor builds the shards to match the contents of |d_pool| */
+template <class Entry, typename Number>
+  ConcurrentHashTable<Entry,Number>::ConcurrentHashTable
+    (typename Entry::Pooltype& pool)
+    : pool_lock(), d_pool(pool) // caller supplies pool reference
+    {
+      reconstruct();
+    }
+
+template <class Entry, typename Number>
+  size_t ConcurrentHashTable<Entry,Number>::capacity() const
+  {
+    size_t result=0;
+    for (unsigned int k=0; k<n_shards; ++k)
+    {
+      std::lock_guard<std::mutex> guard(shard[k].lock);
+      result += shard[k].mod;
+    }
+    return result;
+  }
+
+/* In the following auxiliary functions |h| is a hash value from which the
+   bits selecting the shard have already been shifted out */
+
+template <class Entry, typename Number>
+  size_t ConcurrentHashTable<Entry,Number>::locate
+    (const Shard& s, size_t h, const Entry& x) const
+  { Number i;
+    h &= s.mod-1;
+    // the following loop terminates because empty slots are always present
+    while ((i=s.hash[h])!=empty and x!=d_pool[i])
+      if (++h==s.mod) h=0; // move past used slot, wrap around
+    return h;
+  }
+
+template <class Entry, typename Number>
+  void ConcurrentHashTable<Entry,Number>::insert
+    (Shard& s, size_t h, Number i)
+  {
+    h &= s.mod-1;
+    while (s.hash[h]!=empty)
+      if (++h==s.mod) h=0; // find free slot
+    s.hash[h]=i;
+    ++s.count;
+  }
+
+/* Growing a shard only needs to rehash the entries it contains, whose numbers
+   are found in its slots; their hash values are recomputed from |d_pool|
+*/
+template <class Entry, typename Number>
+  void ConcurrentHashTable<Entry,Number>::grow(Shard& s)
+  {
+    std::vector<Number> old(s.mod<<1,empty);
+    old.swap(s.hash); // now |old| holds the previous slots
+    s.mod <<= 1; s.count=0;
+    for (size_t k=0; k<old.size(); ++k)
+      if (old[k]!=empty)
+	insert(s,hash_value(Entry(d_pool[old[k]]))>>shard_shift,old[k]);
+    profile::count("hash tables","rehashes");
+    profile::count("hash tables","entries rehashed",s.count);
+  }
+
+template <class Entry, typename Number>
+  void ConcurrentHashTable<Entry,Number>::reconstruct()
+  {
+    for (unsigned int k=0; k<n_shards; ++k)
+    {
+      shard[k].mod=initial_mod; shard[k].count=0;
+      shard[k].hash.assign(initial_mod,empty);
+    }
+
+    for (size_t i=0; i<d_pool.size(); ++i)
+    {
+      size_t h=hash_value(Entry(d_pool[i]));
+      Shard& s=shard[h&(n_shards-1)];
+      if (s.count>=max_fill(s.mod))
+	grow(s);
+      insert(s,h>>shard_shift,Number(i));
+    }
+  }
+
+/* This is as for |HashTable|: locate all slots concerned, then relabel them */
+template <class Entry, typename Number>
+  void ConcurrentHashTable<Entry,Number>::renumber
+    (Number from, const std::vector<Number>& new_nr)
+  {
+    std::vector<Number*> slot(new_nr.size());
+    for (size_t k=0; k<new_nr.size(); ++k)
+    {
+      const Number i=Number(from+k);
+      size_t h=hash_value(Entry(d_pool[i]));
+      Shard& s=shard[h&(n_shards-1)];
+      h = (h>>shard_shift)&(s.mod-1);
+      while (s.hash[h]!=i) // entry |i| is present, so this terminates
+	if (++h==s.mod) h=0;
+      slot[k]=&s.hash[h];
+    }
+
+    for (size_t k=0; k<slot.size(); ++k)
+      *slot[k]=new_nr[k];
+  }
+
+/*
+  Every entry from |from| on must occur in some list; after the renumbering
+  the entries appear in the order of their first occurrence. Since |new_nr| is
+  a permutation, following its cycles sorts out |d_pool|.
+*/
+template <class Entry, typename Number>
+template <typename ListIterator>
+  void ConcurrentHashTable<Entry,Number>::renumber_by_use
+    (Number from, ListIterator begin, ListIterator end)
+  {
+    std::vector<Number> new_nr(d_pool.size()-from,empty);
+    Number next = from;
+    for (ListIterator it=begin; it!=end; ++it)
+      for (size_t i=it->size(); i-->0; )
+	if ((*it)[i]>=from)
+	{
+	  Number& nr = new_nr[(*it)[i]-from];
+	  if (nr==empty)
+	    nr = next++;
+	  (*it)[i] = nr;
+	}
+    assert(next==d_pool.size());
+
+    renumber(from,new_nr);
+    for (Number i=from; i<d_pool.size(); ++i)
+      for (Number j; (j=new_nr[i-from])!=i; ) // move entry |i| to |j|
+      {
+	d_pool.interchange(i,j);
+	std::swap(new_nr[i-from],new_nr[j-from]); // the arrival at |i| is next
+      }
+  }
+
+template <class Entry, typename Number>
+  Number ConcurrentHashTable<Entry,Number>::find (const Entry& x) const
+  {
+    size_t h=hash_value(x);
+    const Shard& s=shard[h&(n_shards-1)];
+    std::lock_guard<std::mutex> guard(s.lock);
+    return s.hash[locate(s,h>>shard_shift,x)]; // sequence number, or |empty|
+  }
+
+/* The manipulator |match| holds the lock of the shard of |x| throughout, so
+   that no other thread can insert an entry equal to |x| in the mean time.
+   Adding |x| to |d_pool| also requires |pool_lock|, which is taken after the
+   lock of the shard, and never the other way around, so there is no risk of
+   deadlock. The numbers stored in a shard are those of entries completely
+   added to |d_pool| before the lock of the shard was released, so any thread
+   that obtains such a number can safely access the entry.
+*/
+template <class Entry, typename Number>
+  Number ConcurrentHashTable<Entry,Number>::match (const Entry& x)
+  {
+    size_t h=hash_value(x);
+    Shard& s=shard[h&(n_shards-1)];
+    h >>= shard_shift;
+
+    std::lock_guard<std::mutex> guard(s.lock);
+    size_t slot=locate(s,h,x);
+    if (s.hash[slot]!=empty)
+      return s.hash[slot]; // return sequence number if found
+
+    // now we know x is absent from the table, and must add it to |d_pool|
+    Number i;
+    {
+      std::lock_guard<std::mutex> pool_guard(pool_lock);
+
+      // as for |HashTable|, test whether |Number| can represent the new size
+      if (size_t(Number(d_pool.size()))!=d_pool.size())
+	throw std::runtime_error("Hash table overflow");
+      i=Number(d_pool.size());
+      d_pool.push_back(x);
+    }
+
+    if (s.count>=max_fill(s.mod)) // then grow only this shard, and insert
+    {
+      grow(s);
+      insert(s,h,i);
+    }
+    else // use the slot found above
+    {
+      s.hash[slot]=i;
+      ++s.count;
+    }
+
+    return i;
+  }
+
+} // |namespace hashtable|
+} // |namespace atlas|
@@ -96,6 +96,10 @@ class HashTable
 
   void reconstruct(); // must call when |d_pool| has been changed by others
 
+  // give entries |from+k| the number |new_nr[k]|, a permutation of that range;
+  // the caller must then permute the entries of |d_pool| correspondingly
+  void renumber(Number from, const std::vector<Number>& new_nr);
+
   typedef Number const_iterator;   // type returned by begin() and end()
   typedef const_iterator iterator; // iterators are not mutable
 
@@ -1,5 +1,7 @@
 #include <stdexcept>
 
+#include "profile.h" // counting rehashes
+
 namespace atlas {
 namespace hashtable {
 
@@ -45,6 +47,28 @@ template <class Entry, typename Number>
 
       rehash();
     }
+/* Renumbering only relabels the slots occupied by the entries concerned. We
+   first locate all those slots, and only then overwrite them, since while
+   searching a slot we must be able to recognise it by its old number.
+*/
+template <class Entry, typename Number>
+  void HashTable<Entry,Number>::renumber
+    (Number from, const std::vector<Number>& new_nr)
+    {
+      std::vector<size_t> slot(new_nr.size());
+      for (size_t k=0; k<new_nr.size(); ++k)
+      {
+	const Number i=Number(from+k);
+	size_t h=Entry(d_pool[i]).hashCode(d_mod);
+	while (d_hash[h]!=i) // entry |i| is present, so this terminates
+	  if (++h==d_mod) h=0;
+	slot[k]=h;
+      }
+
+      for (size_t k=0; k<slot.size(); ++k)
+	d_hash[slot[k]]=new_nr[k];
+    }
+
 /* the accessor |find| is fairly easy; it need not (and cannot) rehash */
 
 template <class Entry, typename Number>
@@ -89,6 +113,8 @@ template <class Entry, typename Number>
     // now test if rehash is necessary
     if (d_pool.size()>=max_fill()) // then we expand d_hash, and rehash
     {
+      profile::count("hash tables","rehashes");
+      profile::count("hash tables","entries rehashed",d_pool.size());
       d_mod=d_mod<<1;  // keep it a power of 2
 
       rehash();
@@ -16,6 +16,7 @@ namespace atlas {
 
 namespace hashtable {
   template <class Entry, typename Number> class HashTable;
+  template <class Entry, typename Number> class ConcurrentHashTable;
 }
 
 }
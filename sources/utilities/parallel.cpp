@@ -0,0 +1,45 @@
+/*
+  This is parallel.cpp
+
+  part of the Atlas of Lie Groups and Representations
+
+  For license information see the LICENSE file
+*/
+
+#include "parallel.h"
+
+#include <thread>
+
+namespace atlas {
+
+namespace parallel {
+
+namespace {
+
+  // the default is to compute sequentially, unless explicitly asked otherwise
+  unsigned int n_threads = 1;
+
+} // |namespace|
+
+unsigned int thread_count() { return n_threads; }
+
+bool& helper::in_worker()
+{
+  static thread_local bool busy = false;
+  return busy;
+}
+
+unsigned int hardware_threads()
+{
+  unsigned int n = std::thread::hardware_concurrency();
+  return n==0 ? 1 : n; // 0 means the number could not be determined
+}
+
+void set_thread_count(unsigned int n)
+{
+  n_threads = n==0 ? hardware_threads() : n;
+}
+
+} // |namespace parallel|
+
+} // |namespace atlas|
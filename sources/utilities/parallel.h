@@ -0,0 +1,55 @@
+/*
+  This is parallel.h
+
+  part of the Atlas of Lie Groups and Representations
+
+  For license information see the LICENSE file
+*/
+
+/* Minimal support for running independent tasks on several threads */
+
+#ifndef PARALLEL_H  /* guard against multiple inclusions */
+#define PARALLEL_H
+
+#include <cstddef>
+
+namespace atlas {
+
+namespace parallel {
+
+/******** function declarations *********************************************/
+
+  // number of threads that computations may use; always at least 1
+  unsigned int thread_count();
+
+  // set that number; 0 selects the number of hardware threads available
+  void set_thread_count(unsigned int n);
+
+  // the value |set_thread_count(0)| would select
+  unsigned int hardware_threads();
+
+/*
+  Call |f(i)| for every |i| in $[begin,end)$, distributing the calls over at
+  most |thread_count()| threads (the caller being one of them). Indices are
+  handed out in increasing order, but calls for different |i| may overlap in
+  time and complete in any order, so |f| must be safe for such use. If some
+  call throws, no further indices are handed out, and once all threads have
+  stopped, the first exception caught is rethrown in the calling thread. A
+  call made from within |f| (by a thread already working for an outer call)
+  runs sequentially in that thread, so nesting does not multiply threads.
+*/
+  template<typename F>
+    void for_each_index(size_t begin, size_t end, F& f);
+
+  namespace helper {
+  // whether the current thread is working for some |for_each_index| call
+    bool& in_worker();
+  } // |namespace helper|
+
+} // |namespace parallel|
+
+} // |namespace atlas|
+
+#include "parallel_def.h"
+
+#endif
@@ -0,0 +1,124 @@
+/*
+  This is parallel_def.h
+
+  part of the Atlas of Lie Groups and Representations
+
+  For license information see the LICENSE file
+*/
+
+/* Template definitions for parallel.h */
+
+#include <vector>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <mutex>
+
+namespace atlas {
+
+namespace parallel {
+
+namespace helper {
+
+/*
+  The state shared by the threads of one call of |for_each_index|: the next
+  index to hand out, and the first exception that was thrown, if any. Handing
+  out indices is serialised by a mutex; this is only intended for tasks whose
+  work is much larger than the cost of taking a lock.
+*/
+class index_dispenser
+{
+  std::mutex lock;
+  size_t next, end;
+  std::exception_ptr failure;
+
+ public:
+  index_dispenser(size_t begin, size_t end)
+    : lock(), next(begin), end(end), failure() {}
+
+  bool get(size_t& i) // get next index into |i|; return whether there was one
+  { std::lock_guard<std::mutex> guard(lock);
+    if (next>=end)
+      return false;
+    i=next++;
+    return true;
+  }
+
+  void fail(std::exception_ptr e) // record |e| unless some failure came first
+  { std::lock_guard<std::mutex> guard(lock);
+    if (failure==nullptr)
+      failure=e;
+    next=end; // hand out no further indices
+  }
+
+  void rethrow_failure() const // only call after all threads have terminated
+  { if (failure!=nullptr)
+      std::rethrow_exception(failure);
+  }
+}; // |class index_dispenser|
+
+// the function object that each thread of |for_each_index| runs
+template<typename F>
+  class index_worker
+{
+  index_dispenser& source;
+  F& f;
+
+ public:
+  index_worker(index_dispenser& source, F& f) : source(source), f(f) {}
+
+  void operator() ()
+  { size_t i;
+    bool& busy = in_worker();
+    const bool was_busy = busy; // the calling thread may be a worker already
+    busy = true;
+    try
+    {
+      while (source.get(i))
+	f(i);
+    }
+    catch (...)
+    { source.fail(std::current_exception()); }
+    busy = was_busy;
+  }
+}; // |class index_worker|
+
+} // |namespace helper|
+
+template<typename F>
+  void for_each_index(size_t begin, size_t end, F& f)
+{
+  if (begin>=end)
+    return;
+  size_t n_threads = helper::in_worker() ? 1 : thread_count(); // see above
+  if (n_threads>end-begin)
+    n_threads=end-begin; // there is no point in having idle threads
+
+  if (n_threads==1) // then avoid all overhead, and just loop over the indices
+  {
+    for (size_t i=begin; i<end; ++i)
+      f(i);
+    return;
+  }
+
+  helper::index_dispenser source(begin,end);
+  helper::index_worker<F> work(source,f);
+
+  std::vector<std::thread> helpers; helpers.reserve(n_threads-1);
+  try
+  {
+    while (helpers.size()+1<n_threads)
+      helpers.push_back(std::thread(work));
+  }
+  catch (std::system_error&) {} // if the system refuses, make do with fewer
+
+  work(); // the calling thread takes its share of the work too
+  for (size_t i=0; i<helpers.size(); ++i)
+    helpers[i].join();
+
+  source.rethrow_failure();
+}
+
+} // |namespace parallel|
+
+} // |namespace atlas|
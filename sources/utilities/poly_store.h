@@ -0,0 +1,134 @@
+/*
+  This is poly_store.h
+
+  part of the Atlas of Lie Groups and Representations
+
+  For license information see the LICENSE file
+*/
+
+/*
+  Compact append-only storage for a large number of polynomials.
+
+  Storing polynomials as a vector of |Polynomial| values costs a separate heap
+  allocation per polynomial, plus the |std::vector| header and the overhead of
+  the allocator; for the small polynomials that Kazhdan-Lusztig computations
+  produce by the million, this is several times the size of the coefficients
+  themselves. A |Poly_store| instead copies the coefficients into large chunks
+  of memory (an arena), each polynomial being preceded by one word recording
+  its number of coefficients, and only records for each polynomial a pointer
+  to that word. Polynomials cannot be modified once stored, and access is by
+  a |Poly_ref| view into the arena.
+
+  Chunks are never reallocated, and the index is a |segmented_vector|, so
+  nothing moves when polynomials are added. Therefore, just like for
+  |segmented_vector|, threads may read stored polynomials while another thread
+  is adding polynomials, provided access to each polynomial only happens after
+  it has been completely stored; this makes the class suitable as pool for a
+  |ConcurrentHashTable|.
+
+  The coefficient type |C| must be an integral type able to represent the
+  number of coefficients of any polynomial stored.
+*/
+
+#ifndef POLY_STORE_H  /* guard against multiple inclusions */
+#define POLY_STORE_H
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include "polynomials.h"
+#include "segmented_vector.h"
+
+namespace atlas {
+
+namespace polynomials {
+
+template<typename C>
+  class Poly_store
+{
+  enum { chunk_shift = 16 }; // 2-log of the usual number of words in a chunk
+
+  std::vector<C*> chunk; // owned blocks of storage, never reallocated
+  C* free_begin; C* free_end; // unused part of the most recent chunk
+  size_t n_words; // total number of words in |chunk| blocks
+  containers::segmented_vector<const C*> index; // start of each polynomial
+
+ public:
+  typedef Polynomial<C> value_type;
+  typedef Poly_ref<C> const_reference;
+  typedef size_t size_type;
+
+  Poly_store()
+    : chunk(), free_begin(nullptr), free_end(nullptr), n_words(0), index() {}
+
+  Poly_store(const Poly_store& other)
+    : chunk(), free_begin(nullptr), free_end(nullptr), n_words(0), index()
+  { for (size_t i=0; i<other.size(); ++i)
+      push_back(other[i]);
+  }
+
+  Poly_store& operator= (const Poly_store& other)
+  { Poly_store(other).swap(*this); return *this; }
+
+  ~Poly_store() { clear(); }
+
+  void swap(Poly_store& other)
+  { chunk.swap(other.chunk);
+    std::swap(free_begin,other.free_begin);
+    std::swap(free_end,other.free_end);
+    std::swap(n_words,other.n_words);
+    index.swap(other.index);
+  }
+
+// accessors
+  size_t size() const { return index.size(); }
+  bool empty() const { return index.empty(); }
+
+  Poly_ref<C> operator[] (size_t i) const
+  { const C* p=index[i]; return Poly_ref<C>(p+1,size_t(*p)); }
+  Poly_ref<C> back() const { return (*this)[size()-1]; }
+
+  size_t memory_use() const // number of bytes currently allocated
+  { return n_words*sizeof(C)+index.capacity()*sizeof(const C*); }
+
+// manipulators
+  void push_back(Poly_ref<C> p) // store a copy of |p| at the end
+  { const size_t need=p.size()+1; // coefficients, plus their number
+    if (size_t(free_end-free_begin)<need)
+      new_chunk(need);
+    *free_begin=C(p.size());
+    std::copy(p.begin(),p.end(),free_begin+1);
+    index.push_back(free_begin);
+    free_begin+=need;
+  }
+
+  // exchange the polynomials at |i| and |j|; this involves no copying
+  void interchange(size_t i, size_t j) { std::swap(index[i],index[j]); }
+
+  void clear()
+  { index.clear();
+    for (size_t k=0; k<chunk.size(); ++k)
+      delete[] chunk[k];
+    chunk.clear();
+    free_begin=free_end=nullptr;
+    n_words=0;
+  }
+
+ private:
+  void new_chunk(size_t need) // start a chunk with at least |need| words
+  { const size_t words = std::max(need,size_t(1)<<chunk_shift);
+    chunk.reserve(chunk.size()+1); // so that |push_back| below cannot throw
+    free_begin=new C[words];
+    chunk.push_back(free_begin);
+    free_end=free_begin+words;
+    n_words+=words;
+  }
+
+}; // |template<typename C> class Poly_store|
+
+} // |namespace polynomials|
+
+} // |namespace atlas|
+
+#endif
@@ -16,6 +16,7 @@
 
 #include <limits>
 #include <vector>
+#include <algorithm> // for |std::equal|
 #include <iostream>
 
 namespace atlas {
@@ -52,6 +53,43 @@ void safeSubtract(C&, C);// version of |operator-=| testing for underflow
 /******** type definitions **************************************************/
 
 
+/*
+  A read-only view of the coefficients of a polynomial stored elsewhere, for
+  instance in a |Poly_store|. It is cheap to copy, and provides those accessors
+  of |Polynomial| that do not need to own the coefficients. The coefficients
+  viewed must satisfy the invariant of |Polynomial|: the leading one is nonzero,
+  and there are none at all for the zero polynomial.
+*/
+template<typename C> class Poly_ref
+{
+  const C* d_coeffs;
+  size_t d_size;
+
+ public:
+  Poly_ref(const C* coeffs, size_t size) : d_coeffs(coeffs), d_size(size) {}
+  Poly_ref(const Polynomial<C>& p) // view the coefficients of |p|
+    : d_coeffs(p.isZero() ? nullptr : &*p.begin()), d_size(p.size()) {}
+
+  const C& operator[] (Degree i) const { return d_coeffs[i]; }
+  const C coef (Degree i) const { return i>=d_size ? C(0) : d_coeffs[i]; }
+
+  const C* begin() const { return d_coeffs; }
+  const C* end() const { return d_coeffs+d_size; }
+
+  Degree degree() const { return d_size-1; }
+  Degree size() const { return d_size; }
+  bool isZero() const { return d_size==0; }
+  bool degree_less_than (Degree d) const { return d_size<=d; }
+
+  bool operator== (Poly_ref q) const
+  { return d_size==q.d_size and std::equal(begin(),end(),q.begin()); }
+  bool operator!= (Poly_ref q) const { return not operator==(q); }
+
+  std::ostream& print(std::ostream& strm, const char* x) const
+  { return Polynomial<C>(*this).print(strm,x); }
+
+}; // |template<typename C> class Poly_ref|
+
 /*
   Polynomials with coefficients in |C|
 
@@ -76,6 +114,8 @@ template<typename C> class Polynomial
 
 template <typename U>
   Polynomial(const Polynomial<U>& src) : d_data(src.begin(),src.end()) { }
+template <typename U>
+  Polynomial(Poly_ref<U> src) : d_data(src.begin(),src.end()) { }
 
   void swap(Polynomial& other) { d_data.swap(other.d_data); }
 
@@ -168,15 +208,34 @@ template <typename C>
  public:
   Safe_Poly() : base() {} // zero polynomial
   explicit Safe_Poly(Degree d, C c) : base(d,c) {}
+  Safe_Poly(Poly_ref<C> src) : base(src) {} // copy from storage
 
   // unlike |operator+| etc., the following test for negative coefficients
-  void safeAdd(const Safe_Poly& p, Degree d, C c); // *this += c*q^d*p
-  void safeAdd(const Safe_Poly& p, Degree d = 0);  // *this += q^d*p
+  void safeAdd(Poly_ref<C> p, Degree d, C c); // *this += c*q^d*p
+  void safeAdd(Poly_ref<C> p, Degree d = 0);  // *this += q^d*p
   void safeDivide(C c);  // *this = *this/c
   void safe_quotient_by_1_plus_q(Degree delta);  // *this = (*this + mq^d)/(q+1)
 
-  void safeSubtract(const Safe_Poly& p, Degree d, C c);
-  void safeSubtract(const Safe_Poly& p, Degree d = 0 );
+  void safeSubtract(Poly_ref<C> p, Degree d, C c);
+  void safeSubtract(Poly_ref<C> p, Degree d = 0 );
+
+  // versions of the above allowing |p| to be |*this|
+  void safeAdd(const Safe_Poly& p, Degree d, C c)
+  { if (&p==this) safeAdd(Poly_ref<C>(Safe_Poly(p)),d,c);
+    else safeAdd(Poly_ref<C>(p),d,c);
+  }
+  void safeAdd(const Safe_Poly& p, Degree d = 0)
+  { if (&p==this) safeAdd(Poly_ref<C>(Safe_Poly(p)),d);
+    else safeAdd(Poly_ref<C>(p),d);
+  }
+  void safeSubtract(const Safe_Poly& p, Degree d, C c)
+  { if (&p==this) safeSubtract(Poly_ref<C>(Safe_Poly(p)),d,c);
+    else safeSubtract(Poly_ref<C>(p),d,c);
+  }
+  void safeSubtract(const Safe_Poly& p, Degree d = 0)
+  { if (&p==this) safeSubtract(Poly_ref<C>(Safe_Poly(p)),d);
+    else safeSubtract(Poly_ref<C>(p),d);
+  }
 
 }; // |template <typename C> class Safe_Poly|
 
@@ -406,16 +406,16 @@ template<typename C> void safeSubtract(C& a, C b)
 
   NOTE: may forward a NumericOverflow exception.
 
-  NOTE: we need to be careful in the case where q = *this, but we can
-  avoid making a copy, by doing the addition top-to-bottom.
+  NOTE: |q| must not view |*this|, as resizing could invalidate it; the
+  overload taking |const Safe_Poly&| makes a copy in that case.
 */
 template<typename C>
-void Safe_Poly<C>::safeAdd(const Safe_Poly& q, Degree d, C c)
+void Safe_Poly<C>::safeAdd(Poly_ref<C> q, Degree d, C c)
 {
   if (q.isZero()) // do nothing
     return;
 
-  size_t qs = q.size();   // save the original size of q, it might change
+  size_t qs = q.size();
 
   // find degree of result
   if (q.size()+d > base::size())
@@ -432,12 +432,12 @@ void Safe_Poly<C>::safeAdd(const Safe_Poly& q, Degree d, C c)
 /* A simplified version avoiding multiplication in the common case |c==1| */
 
 template<typename C>
-void Safe_Poly<C>::safeAdd(const Safe_Poly& q, Degree d)
+void Safe_Poly<C>::safeAdd(Poly_ref<C> q, Degree d)
 {
   if (q.isZero()) // do nothing
     return;
 
-  size_t qs = q.size();   // save the original size of q, it might change
+  size_t qs = q.size();
 
   // find degree
   if (q.size()+d > base::size())
@@ -503,16 +503,15 @@ void Safe_Poly<C>::safe_quotient_by_1_plus_q(Degree delta)
 
   NOTE: may forward a NumericUnderflow exception.
 
-  NOTE: q = *this is possible only for d = 0; still, we do the prudent thing
-  and subtract backwards.
+  NOTE: |q| cannot view |*this|; the |Safe_Poly| overload takes care of that.
 */
 template<typename C>
-void Safe_Poly<C>::safeSubtract(const Safe_Poly& q, Degree d, C c)
+void Safe_Poly<C>::safeSubtract(Poly_ref<C> q, Degree d, C c)
 {
   if (q.isZero()) // do nothing
     return;
 
-  size_t qs = q.size();   // save the original size of q, it might change
+  size_t qs = q.size();
 
   if (q.size()+d > base::size()) // underflow, leading coef becomes negative
     throw error::NumericUnderflow();
@@ -531,7 +530,7 @@ void Safe_Poly<C>::safeSubtract(const Safe_Poly& q, Degree d, C c)
 /* Again a simplified version deals with the common case |c==1| */
 
 template<typename C>
-void Safe_Poly<C>::safeSubtract(const Safe_Poly& q, Degree d)
+void Safe_Poly<C>::safeSubtract(Poly_ref<C> q, Degree d)
 
 {
   if (q.isZero()) // do nothing
@@ -20,6 +20,8 @@ namespace polynomials {
 
 template<typename C> class Polynomial; // |C| can be any arithmetic type
 template<typename C> class Safe_Poly;  // here |C| must be unsigned integral
+template<typename C> class Poly_ref;   // view of polynomial stored elsewhere
+template<typename C> class Poly_store; // compact storage of many polynomials
 
 // template<typename C> class LaurentPolynomial;
 
@@ -0,0 +1,164 @@
+/*
+  This is profile.cpp
+
+  part of the Atlas of Lie Groups and Representations
+
+  For license information see the LICENSE file
+*/
+
+#include "profile.h"
+
+#include <iomanip>
+#include <mutex>
+
+#include <sys/time.h>
+#include <sys/resource.h> // for |getrusage|
+#ifdef __GLIBC__
+#include <malloc.h> // for |mallinfo2|
+#endif
+
+namespace atlas {
+
+namespace profile {
+
+namespace {
+
+  std::mutex table_mutex; // protects |table|
+  std::map<std::string,phase_record> table; // all records, by phase name
+
+  unsigned long resident_kB() // largest resident set size so far
+  {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+      return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss/1024; // reported in bytes there
+#else
+    return usage.ru_maxrss; // reported in kilobytes
+#endif
+  }
+
+  // write |s| as a JSON string; phase and counter names are plain ASCII
+  void json_string(std::ostream& out, const std::string& s)
+  {
+    out << '"';
+    for (auto it=s.begin(); it!=s.end(); ++it)
+      if (*it=='"' or *it=='\\')
+	out << '\\' << *it;
+      else
+	out << *it;
+    out << '"';
+  }
+
+} // |namespace|
+
+// the heap statistics of the C library, where available; they are process-wide
+unsigned long long heap_bytes()
+{
+#if defined(__GLIBC__) and (__GLIBC__>2 or __GLIBC_MINOR__>=33)
+  const struct mallinfo2 info = mallinfo2();
+  return info.uordblks+info.hblkhd; // in use in arenas, plus |mmap|ped blocks
+#else
+  return 0; // so that |heap_growth| stays 0
+#endif
+}
+
+phase::~phase()
+{
+  const double elapsed = std::chrono::duration<double>
+    (std::chrono::steady_clock::now()-start).count();
+  const unsigned long resident = resident_kB();
+  const long long growth = static_cast<long long>(heap_bytes()-start_heap);
+
+  std::lock_guard<std::mutex> lock(table_mutex);
+  phase_record& rec = table[name];
+  ++rec.calls;
+  rec.seconds += elapsed;
+  if (resident>rec.max_resident_kB)
+    rec.max_resident_kB = resident;
+  rec.heap_growth += growth;
+  for (auto it=counts.begin(); it!=counts.end(); ++it)
+    rec.counters[it->first] += it->second;
+}
+
+void count(const char* name, const char* counter, unsigned long long n)
+{
+  std::lock_guard<std::mutex> lock(table_mutex);
+  table[name].counters[counter] += n;
+}
+
+std::vector<std::pair<std::string,phase_record> > records()
+{
+  std::lock_guard<std::mutex> lock(table_mutex);
+  return std::vector<std::pair<std::string,phase_record> >
+    (table.begin(),table.end());
+}
+
+void reset()
+{
+  std::lock_guard<std::mutex> lock(table_mutex);
+  table.clear();
+}
+
+void print(std::ostream& out)
+{
+  const auto recs = records();
+  if (recs.empty())
+  {
+    out << "no phases recorded." << std::endl;
+    return;
+  }
+  const std::ios_base::fmtflags flags = out.flags(); // restored at the end
+  const std::streamsize precision = out.precision();
+  for (auto it=recs.begin(); it!=recs.end(); ++it)
+  {
+    const phase_record& rec = it->second;
+    out << std::left << std::setw(24) << it->first << std::right
+	<< " calls:" << std::setw(8) << rec.calls
+	<< ", time:" << std::fixed << std::setprecision(3)
+	<< std::setw(10) << rec.seconds << 's'
+	<< ", max res:" << std::setw(8) << rec.max_resident_kB << "kB"
+	<< ", heap growth:" << std::setw(12) << rec.heap_growth << 'B';
+    for (auto c=rec.counters.begin(); c!=rec.counters.end(); ++c)
+      out << ", " << c->first << ": " << c->second;
+    out << std::endl;
+  }
+  out.flags(flags); out.precision(precision);
+}
+
+void write_json(std::ostream& out)
+{
+  const auto recs = records();
+  const std::ios_base::fmtflags flags = out.flags(); // restored at the end
+  const std::streamsize precision = out.precision();
+  out << '{';
+  for (auto it=recs.begin(); it!=recs.end(); ++it)
+  {
+    const phase_record& rec = it->second;
+    if (it!=recs.begin())
+      out << ',';
+    out << "\n  ";
+    json_string(out,it->first);
+    out << ": { \"calls\": " << rec.calls
+	<< ", \"seconds\": " << std::fixed << std::setprecision(6)
+	<< rec.seconds
+	<< ", \"max_resident_kB\": " << rec.max_resident_kB
+	<< ", \"heap_growth_bytes\": " << rec.heap_growth
+	<< ", \"counters\": {";
+    for (auto c=rec.counters.begin(); c!=rec.counters.end(); ++c)
+    {
+      if (c!=rec.counters.begin())
+	out << ',';
+      out << ' ';
+      json_string(out,c->first);
+      out << ": " << c->second;
+    }
+    out << " } }";
+  }
+  out << "\n}" << std::endl;
+  out.flags(flags); out.precision(precision);
+}
+
+} // |namespace profile|
+
+} // |namespace atlas|
@@ -0,0 +1,94 @@
+/*
+  This is profile.h
+
+  part of the Atlas of Lie Groups and Representations
+
+  For license information see the LICENSE file
+*/
+
+/* Named phase timers and counters, for finding where computations spend time */
+
+#ifndef PROFILE_H  /* guard against multiple inclusions */
+#define PROFILE_H
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace atlas {
+
+namespace profile {
+
+/******** type definitions **************************************************/
+
+/*
+  Accumulated figures for one named phase of a computation. The time recorded
+  is wall clock time, and includes that of nested phases. Each phase has its
+  own counters, which the instrumented code increases as it sees fit (numbers
+  of elements generated, polynomials stored, and so on); the largest resident
+  set size of the process seen at the end of a call is also recorded, as is
+  the growth of the heap during calls (bytes allocated and not yet freed at
+  the end of the call; this includes allocations by other threads meanwhile).
+*/
+struct phase_record
+{
+  unsigned long long calls;
+  double seconds;
+  unsigned long max_resident_kB;
+  long long heap_growth; // in bytes, summed over calls; may be negative
+  std::map<std::string,unsigned long long> counters;
+
+  phase_record()
+  : calls(0), seconds(0.0), max_resident_kB(0), heap_growth(0), counters() {}
+}; // |struct phase_record|
+
+/*
+  A timer for one call of a named phase: construct it at the start of the
+  phase, and the call is recorded when it is destroyed. Records are kept in a
+  global table protected by a mutex, so phases may be timed in any thread;
+  they should not be placed in very short inner loops.
+*/
+unsigned long long heap_bytes(); // bytes allocated on the heap, or 0 if unknown
+
+class phase
+{
+  const char* name;
+  std::chrono::steady_clock::time_point start;
+  unsigned long long start_heap; // |heap_bytes()| at construction
+  std::map<std::string,unsigned long long> counts; // added to record at end
+
+ public:
+  explicit phase(const char* name)
+    : name(name), start(std::chrono::steady_clock::now())
+    , start_heap(heap_bytes()), counts() {}
+  ~phase();
+
+  // add |n| to the counter |counter| of this phase (at the end of the call)
+  void count(const char* counter, unsigned long long n=1)
+  { counts[counter]+=n; }
+
+ private: // timers are not to be copied
+  phase(const phase&);
+  phase& operator=(const phase&);
+}; // |class phase|
+
+/******** function declarations *********************************************/
+
+  // add |n| to the counter |counter| of phase |name|, outside any timer
+  void count(const char* name, const char* counter, unsigned long long n=1);
+
+  // a copy of all records, ordered by phase name
+  std::vector<std::pair<std::string,phase_record> > records();
+
+  void reset(); // forget all records
+
+  void print(std::ostream& out); // as a table, one line per phase
+  void write_json(std::ostream& out); // as a JSON object indexed by phase
+
+} // |namespace profile|
+
+} // |namespace atlas|
+
+#endif
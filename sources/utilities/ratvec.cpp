@@ -30,12 +30,21 @@ RationalVector<C>::RationalVector(const  matrix::Vector<C1>& v, C d)
   : d_num(v.begin(),v.end()), d_denom(std::abs(d))
 { if (d<C(0)) d_num*=-C(1); }
 
-// the following implementation assumes |long| can hold cross products
+// vectors are compared component-wise, without forming any temporary vectors
+// cross products are checked, and throw |std::overflow_error| if too large
 template<typename C>
   bool RationalVector<C>::operator==(const RationalVector<C>& v) const
-{ return  // cross multiply
-    d_num*arithmetic::Numer_t(v.d_denom) ==
-    v.d_num*arithmetic::Numer_t(d_denom);
+{
+  if (d_num.size()!=v.d_num.size())
+    return false;
+  if (d_denom==v.d_denom) // the most frequent case: just compare numerators
+    return d_num==v.d_num;
+  const arithmetic::Numer_t d0(d_denom), d1(v.d_denom);
+  for (size_t i=0; i<d_num.size(); ++i) // cross multiply
+    if (arithmetic::checked_mul<C>(d_num[i],d1) !=
+	arithmetic::checked_mul<C>(v.d_num[i],d0))
+      return false;
+  return true;
 }
 
 template<typename C>
@@ -43,26 +52,50 @@ template<typename C>
 { // cross multiply component-wise, and compare
   for (size_t i=0; i<d_num.size(); ++i)
   {
-    C d = d_num[i]*arithmetic::Numer_t(v.d_denom)
-      - v.d_num[i]*arithmetic::Numer_t(d_denom);
-    if (d!=0)
-      return d<0;
+    C a = arithmetic::checked_mul<C>(d_num[i],v.d_denom);
+    C b = arithmetic::checked_mul<C>(v.d_num[i],d_denom);
+    if (a!=b)
+      return a<b;
   }
   return false; // equality if we get here
 }
 
+// sum and difference build the numerator of the result in a single pass, with
+// checked arithmetic so that overflow throws rather than giving wrong values
 template<typename C>
 RationalVector<C> RationalVector<C>::operator+(const RationalVector<C>& v)
   const
 {
-  arithmetic::Denom_t gcd, m = arithmetic::lcm(d_denom,v.d_denom,gcd);
-  arithmetic::Denom_t f = v.d_denom/gcd;
-  assert (f==m/d_denom); // if this fails, then there was overflow on m
-  RationalVector<C> result(d_num*f,m); // |operator*| returns |Ratvec_Numer_t|
-  result.d_num += v.d_num*(d_denom/gcd);
+  assert(d_num.size()==v.d_num.size());
+  const arithmetic::Denom_t gcd = arithmetic::unsigned_gcd(d_denom,v.d_denom);
+  const C f = v.d_denom/gcd, g = d_denom/gcd;
+  const arithmetic::Denom_t m = // least common multiple of denominators
+    arithmetic::checked_mul(d_denom,arithmetic::Denom_t(f));
+  RationalVector<C> result(d_num.size()); // zero, will overwrite numerator
+  result.d_denom = m;
+  for (size_t i=0; i<d_num.size(); ++i)
+    result.d_num[i] = arithmetic::checked_add
+      (arithmetic::checked_mul(d_num[i],f),arithmetic::checked_mul(v.d_num[i],g));
   return result; // don't normalize, better just limit denominator growth
 }
 
+template<typename C>
+RationalVector<C> RationalVector<C>::operator-(const RationalVector<C>& v)
+  const
+{
+  assert(d_num.size()==v.d_num.size());
+  const arithmetic::Denom_t gcd = arithmetic::unsigned_gcd(d_denom,v.d_denom);
+  const C f = v.d_denom/gcd, g = d_denom/gcd;
+  const arithmetic::Denom_t m = // least common multiple of denominators
+    arithmetic::checked_mul(d_denom,arithmetic::Denom_t(f));
+  RationalVector<C> result(d_num.size());
+  result.d_denom = m;
+  for (size_t i=0; i<d_num.size(); ++i)
+    result.d_num[i] = arithmetic::checked_sub
+      (arithmetic::checked_mul(d_num[i],f),arithmetic::checked_mul(v.d_num[i],g));
+  return result;
+}
+
 // rational vectors are not guaranteed on lowest terms
 // however if multiplication can be done by cancellation, it is done that way
 template<typename C>
@@ -77,7 +110,9 @@ RationalVector<C>& RationalVector<C>::operator*=(C n)
       d_num=-d_num;
       d_denom/=arithmetic::Numer_t(-n);
     }
-  else d_num*=n;
+  else
+    for (auto it=d_num.begin(); it!=d_num.end(); ++it)
+      *it = arithmetic::checked_mul(*it,n);
   return *this;
 }
 
@@ -89,11 +124,12 @@ RationalVector<C>& RationalVector<C>::operator/=(C n)
 {
   assert(n!=0);
   if (n>0)
-    d_denom*=arithmetic::Denom_t(n);
+    d_denom=arithmetic::checked_mul(d_denom,arithmetic::Denom_t(n));
   else
   {
     d_num=-d_num;
-    d_denom*=-arithmetic::Denom_t(n); // safe to convert to unsigned, negate
+    d_denom=arithmetic::checked_mul // safe to convert to unsigned, negate
+      (d_denom,-arithmetic::Denom_t(n));
   }
   return *this;
 }
@@ -102,8 +138,10 @@ template<typename C>
 RationalVector<C>& RationalVector<C>::operator%=(C n)
 {
   assert(n!=0);
+  const arithmetic::Denom_t m =
+    arithmetic::checked_mul(d_denom,arithmetic::Denom_t(std::abs(n)));
   for (auto it=d_num.begin(); it!=d_num.end(); ++it)
-    *it = arithmetic::remainder(*it,d_denom*arithmetic::Denom_t(std::abs(n)));
+    *it = arithmetic::remainder(*it,m);
   return *this;
 }
 
@@ -115,7 +153,12 @@ template<typename C>
 RationalVector<C> RationalVector<C>::operator*(const arithmetic::Rational& r)
 const
 {
-  return RationalVector(d_num*r.numerator(),d_denom*r.denominator());
+  RationalVector result(*this);
+  for (auto it=result.d_num.begin(); it!=result.d_num.end(); ++it)
+    *it = arithmetic::checked_mul<C>(*it,r.numerator());
+  result.d_denom = arithmetic::checked_mul<arithmetic::Denom_t>
+    (d_denom,r.denominator());
+  return result;
 }
 
 template<typename C>
@@ -128,7 +171,14 @@ template<typename C>
 RationalVector<C> RationalVector<C>::operator/(const arithmetic::Rational& r)
 const
 {
-  return RationalVector(d_num*r.denominator(),d_denom*r.numerator());
+  assert (r.numerator()!=0);
+  const C n = r.numerator()>0 ? r.denominator() : -r.denominator();
+  RationalVector result(*this);
+  for (auto it=result.d_num.begin(); it!=result.d_num.end(); ++it)
+    *it = arithmetic::checked_mul(*it,n);
+  result.d_denom = arithmetic::checked_mul<arithmetic::Denom_t>
+    (d_denom,std::abs(r.numerator()));
+  return result;
 }
 
 template<typename C>
@@ -148,7 +198,8 @@ RationalVector<C>& RationalVector<C>::normalize()
   }
 
   d_denom/=d;
-  d_num/=C(d);
+  for (auto it=d_num.begin(); it!=d_num.end(); ++it)
+    *it /= C(d); // exact: |d| divides every entry by construction
   return *this;
 }
 
@@ -68,8 +68,7 @@ class RationalVector
   { return *this=*this+v; }
   RationalVector operator-() const
   { return RationalVector(-d_num,d_denom); }
-  RationalVector operator-(const RationalVector& v) const
-  { return *this+-v; }
+  RationalVector operator-(const RationalVector& v) const;
   RationalVector& operator-=(const RationalVector& v)
   { return *this=*this-v; }
   RationalVector& operator*=(C n);
@@ -0,0 +1,133 @@
+/*
+  This is segmented_vector.h
+
+  part of the Atlas of Lie Groups and Representations
+
+  For license information see the LICENSE file
+*/
+
+/*
+  A growable random access container whose elements never move once stored.
+
+  Elements live in a fixed number of segments of doubling size; segment |k|
+  holds $2^{b+k}$ elements where $b$ is |base_shift|, and is allocated only
+  when the first element it is to contain is pushed. Since the table of
+  segment pointers has fixed size, growing never relocates anything: unlike
+  for |std::vector|, references to elements remain valid under |push_back|.
+
+  This makes it suitable as a pool that is read by several threads while it is
+  being extended: provided only one thread at a time calls |push_back|, and
+  others only access elements whose storage is guaranteed to have completed
+  before (as established for instance by a mutex both threads have taken),
+  there are no data races. In particular the pool of a hash table that is
+  shared between threads can be a |segmented_vector|.
+*/
+
+#ifndef SEGMENTED_VECTOR_H  /* guard against multiple inclusions */
+#define SEGMENTED_VECTOR_H
+
+#include <cstddef>
+#include <memory>
+#include <algorithm>
+#include <utility>
+
+#include "constants.h"
+#include "bits.h"
+
+namespace atlas {
+
+namespace containers {
+
+template<typename T>
+  class segmented_vector
+{
+  enum { base_shift = 8 }; // 2-log of the size of the first segment
+  static const unsigned int max_segments = constants::sizeBits-base_shift;
+
+  T* segment[max_segments]; // only the first |n_segments| are allocated
+  unsigned int n_segments;
+  size_t d_size;
+
+ public:
+  typedef T value_type;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef size_t size_type;
+
+  segmented_vector() : n_segments(0), d_size(0) {}
+
+  segmented_vector(const segmented_vector& other)
+    : n_segments(0), d_size(0)
+  { for (size_t i=0; i<other.size(); ++i)
+      push_back(other[i]);
+  }
+
+  segmented_vector& operator= (const segmented_vector& other)
+  { segmented_vector(other).swap(*this); return *this; }
+
+  ~segmented_vector() { clear(); }
+
+  void swap(segmented_vector& other)
+  { std::swap_ranges(&segment[0],&segment[max_segments],&other.segment[0]);
+    std::swap(n_segments,other.n_segments);
+    std::swap(d_size,other.d_size);
+  }
+
+// accessors
+  size_t size() const { return d_size; }
+  bool empty() const { return d_size==0; }
+  size_t capacity() const // number of elements storable without allocating
+  { return ((size_t(1)<<n_segments)-1)<<base_shift; }
+
+  const T& operator[] (size_t i) const
+  { size_t j = i+(size_t(1)<<base_shift); unsigned int k=segment_of(j);
+    return segment[k][j-(size_t(1)<<(base_shift+k))];
+  }
+  const T& back() const { return (*this)[d_size-1]; }
+
+// manipulators
+  T& operator[] (size_t i)
+  { size_t j = i+(size_t(1)<<base_shift); unsigned int k=segment_of(j);
+    return segment[k][j-(size_t(1)<<(base_shift+k))];
+  }
+  T& back() { return (*this)[d_size-1]; }
+
+  void push_back(const T& val) { new (slot()) T(val); ++d_size; }
+  void push_back(T&& val) { new (slot()) T(std::move(val)); ++d_size; }
+
+  void clear()
+  { while (d_size>0)
+      (*this)[--d_size].~T();
+    while (n_segments>0)
+    { --n_segments;
+      std::allocator<T>().deallocate
+	(segment[n_segments],size_t(1)<<(base_shift+n_segments));
+    }
+  }
+
+ private:
+  static unsigned int segment_of(size_t j) // for |j>=(1<<base_shift)|
+  {
+#ifdef __GNUC__
+    return constants::sizeBits-1-__builtin_clzl(j)-base_shift;
+#else
+    return bits::lastBit(j)-1-base_shift;
+#endif
+  }
+
+  T* slot() // uninitialised storage for the element at index |d_size|
+  { size_t j = d_size+(size_t(1)<<base_shift); unsigned int k=segment_of(j);
+    if (k==n_segments) // then a new segment is needed
+    { segment[k] = std::allocator<T>().allocate(size_t(1)<<(base_shift+k));
+      ++n_segments; // only now, in case the allocation throws
+    }
+    return &segment[k][j-(size_t(1)<<(base_shift+k))];
+  }
+
+}; // |template<typename T> class segmented_vector|
+
+} // |namespace containers|
+
+} // |namespace atlas|
+
+#endif